@@ -0,0 +1,163 @@
+#include "arena.h"
+#include <stdlib.h>
+
+#define TAM_LOSA 65536
+#define TAM_MINIMO 16                // tamaño de la menor clase; las clases van duplicándose
+#define CANTIDAD_CLASES 6            // clases de 16, 32, 64, 128, 256 y 512 bytes
+#define TAM_MAXIMO (TAM_MINIMO << (CANTIDAD_CLASES - 1))
+
+/* Definición de la estructura de una losa. Los bloques se cortan de 'datos'.
+Los encabezados de losas y bloques grandes ocupan 16 bytes, así los datos quedan
+con la misma alineación que devuelve malloc. */
+typedef struct losa {
+    struct losa* proxima;
+    size_t usado;                   // bytes ya cortados de esta losa
+    unsigned char datos[];
+} losa_t;
+
+/* Definición de la estructura de un bloque grande, pedido aparte de las losas. */
+typedef struct grande {
+    struct grande* anterior;
+    struct grande* proximo;
+    unsigned char datos[];
+} grande_t;
+
+/* Definición de la estructura de un bloque libre: se enlaza dentro del propio bloque. */
+typedef struct libre {
+    struct libre* proximo;
+} libre_t;
+
+/* Definición de la estructura de la arena */
+struct arena {
+    losa_t* losas;                          // losas pedidas, la primera es la que se está cortando
+    libre_t* libres[CANTIDAD_CLASES];       // bloques liberados de cada clase
+    grande_t* grandes;
+    size_t memoria;                         // bytes pedidos a malloc, incluidos los encabezados
+};
+
+/* ******************************************************************
+ *                    FUNCIONES AUXILIARES
+ * *****************************************************************/
+
+// Devuelve la clase que corresponde a un pedido de tam bytes.
+// Pre: tam es menor o igual a TAM_MAXIMO.
+size_t arena_clase(size_t tam){
+    size_t clase = 0;
+    while ((size_t)(TAM_MINIMO << clase) < tam){
+        clase++;
+    }
+    return clase;
+}
+
+// Pide un bloque grande y lo enlaza a la lista de la arena.
+void *arena_pedir_grande(arena_t *arena, size_t tam){
+    grande_t* grande = malloc(sizeof(grande_t) + tam);
+    if (grande == NULL){
+        return NULL;
+    }
+    grande->anterior = NULL;
+    grande->proximo = arena->grandes;
+    if (arena->grandes != NULL){
+        arena->grandes->anterior = grande;
+    }
+    arena->grandes = grande;
+    arena->memoria += sizeof(grande_t) + tam;
+    return grande->datos;
+}
+
+// Desenlaza un bloque grande de tam bytes de la arena y lo libera.
+void arena_liberar_grande(arena_t *arena, void *bloque, size_t tam){
+    grande_t* grande = (grande_t*)((unsigned char*)bloque - offsetof(grande_t, datos));
+
+    if (grande->anterior != NULL){
+        grande->anterior->proximo = grande->proximo;
+    } else {
+        arena->grandes = grande->proximo;
+    }
+    if (grande->proximo != NULL){
+        grande->proximo->anterior = grande->anterior;
+    }
+    arena->memoria -= sizeof(grande_t) + tam;
+    free(grande);
+}
+
+/* ******************************************************************
+ *                    PRIMITIVAS DE LA ARENA
+ * *****************************************************************/
+
+arena_t *arena_crear(void){
+    arena_t* arena = malloc(sizeof(arena_t));
+    if (arena == NULL){
+        return NULL;
+    }
+    arena->losas = NULL;
+    for (size_t i = 0; i < CANTIDAD_CLASES; i++){
+        arena->libres[i] = NULL;
+    }
+    arena->grandes = NULL;
+    arena->memoria = sizeof(arena_t);
+    return arena;
+}
+
+void *arena_pedir(arena_t *arena, size_t tam){
+    if (tam > TAM_MAXIMO){
+        return arena_pedir_grande(arena, tam);
+    }
+
+    size_t clase = arena_clase(tam);
+    libre_t* libre = arena->libres[clase];
+    if (libre != NULL){                             // se reutiliza un bloque liberado
+        arena->libres[clase] = libre->proximo;
+        return libre;
+    }
+
+    size_t tam_clase = (size_t)TAM_MINIMO << clase;
+    losa_t* losa = arena->losas;
+    if (losa == NULL || losa->usado + tam_clase > TAM_LOSA){       // la losa actual no alcanza
+        losa = malloc(sizeof(losa_t) + TAM_LOSA);
+        if (losa == NULL){
+            return NULL;
+        }
+        losa->proxima = arena->losas;
+        losa->usado = 0;
+        arena->losas = losa;
+        arena->memoria += sizeof(losa_t) + TAM_LOSA;
+    }
+
+    void* bloque = losa->datos + losa->usado;
+    losa->usado += tam_clase;
+    return bloque;
+}
+
+void arena_liberar(arena_t *arena, void *bloque, size_t tam){
+    if (tam > TAM_MAXIMO){
+        arena_liberar_grande(arena, bloque, tam);
+        return;
+    }
+
+    size_t clase = arena_clase(tam);
+    libre_t* libre = bloque;
+    libre->proximo = arena->libres[clase];
+    arena->libres[clase] = libre;
+}
+
+size_t arena_memoria(const arena_t *arena){
+    return arena->memoria;
+}
+
+void arena_destruir(arena_t *arena){
+    losa_t* losa = arena->losas;
+    while (losa != NULL){
+        losa_t* proxima = losa->proxima;
+        free(losa);
+        losa = proxima;
+    }
+
+    grande_t* grande = arena->grandes;
+    while (grande != NULL){
+        grande_t* proximo = grande->proximo;
+        free(grande);
+        grande = proximo;
+    }
+    free(arena);
+}
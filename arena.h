@@ -0,0 +1,44 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+
+/* ******************************************************************
+ *                DEFINICION DE LOS TIPOS DE DATOS
+ * *****************************************************************/
+
+/* La arena reparte bloques de memoria cortados de losas (slabs) grandes.
+ * Los bloques se agrupan por clases de tamaño; un bloque liberado queda
+ * disponible para el próximo pedido de su misma clase. Los pedidos más
+ * grandes que la mayor clase se piden aparte, pero también pertenecen a
+ * la arena. */
+typedef struct arena arena_t;
+
+/* ******************************************************************
+ *                    PRIMITIVAS DE LA ARENA
+ * *****************************************************************/
+
+// Crea una arena vacía. Devuelve NULL si no pudo crearla.
+arena_t *arena_crear(void);
+
+// Devuelve un bloque de al menos tam bytes, con la misma alineación que malloc,
+// o NULL si no hay memoria.
+// Pre: la arena fue creada.
+void *arena_pedir(arena_t *arena, size_t tam);
+
+// Devuelve el bloque a la arena para que pueda reutilizarse.
+// Pre: el bloque fue obtenido con arena_pedir sobre esta arena con el
+// mismo tam, y no fue liberado antes.
+void arena_liberar(arena_t *arena, void *bloque, size_t tam);
+
+// Devuelve los bytes que la arena pidió a malloc y todavía no devolvió,
+// contando losas enteras aunque estén a medio usar.
+// Pre: la arena fue creada.
+size_t arena_memoria(const arena_t *arena);
+
+// Destruye la arena liberando de una vez todos sus bloques, incluso los
+// que no se liberaron con arena_liberar.
+// Pre: la arena fue creada.
+void arena_destruir(arena_t *arena);
+
+#endif // ARENA_H
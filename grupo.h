@@ -0,0 +1,70 @@
+#ifndef GRUPO_H
+#define GRUPO_H
+
+#include <stdint.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+/* Bytes de control y grupos de las tablas de direccionamiento abierto, compartidos
+ * por hash.c y las tablas de hash_generico.h. Cada posición de una tabla tiene un
+ * byte de control que vale GRUPO_VACIO, GRUPO_BORRADO, o los 7 bits bajos del hash
+ * de su clave (h2); las búsquedas miran de a GRUPO_TAM bytes de control a la vez. */
+
+#define GRUPO_TAM 16
+#define GRUPO_VACIO ((int8_t) -128)     // 0b10000000
+#define GRUPO_BORRADO ((int8_t) -2)     // 0b11111110
+#define GRUPO_H2_MASCARA 0x7F
+
+/* Funciones de grupo: con SSE2 (parte de x86-64, así que no hace falta elegirla en
+ * tiempo de ejecución) cada una compara los GRUPO_TAM bytes de control con una sola
+ * instrucción y arma la máscara con el bit de signo de cada byte; si no, se recorre
+ * el grupo byte por byte. GRUPO_VACIO y GRUPO_BORRADO son los únicos bytes de control
+ * negativos, así que las posiciones libres son justamente las que tienen el bit de
+ * signo. */
+#ifdef __SSE2__
+
+// Devuelve una máscara con un bit encendido por cada posición del grupo cuyo byte
+// de control es igual a h2.
+static inline uint32_t grupo_coincidencias(const int8_t *grupo, int8_t h2){
+    __m128i control = _mm_loadu_si128((const __m128i *) grupo);
+    return (uint32_t) _mm_movemask_epi8(_mm_cmpeq_epi8(control, _mm_set1_epi8(h2)));
+}
+
+// Devuelve una máscara con un bit encendido por cada posición libre (vacía o
+// borrada) del grupo.
+static inline uint32_t grupo_libres(const int8_t *grupo){
+    return (uint32_t) _mm_movemask_epi8(_mm_loadu_si128((const __m128i *) grupo));
+}
+
+#else
+
+static inline uint32_t grupo_coincidencias(const int8_t *grupo, int8_t h2){
+    uint32_t mascara = 0;
+    for (uint32_t i = 0; i < GRUPO_TAM; i++){
+        if (grupo[i] == h2) mascara |= 1u << i;
+    }
+    return mascara;
+}
+
+static inline uint32_t grupo_libres(const int8_t *grupo){
+    uint32_t mascara = 0;
+    for (uint32_t i = 0; i < GRUPO_TAM; i++){
+        if (grupo[i] < 0) mascara |= 1u << i;
+    }
+    return mascara;
+}
+
+#endif
+
+// Devuelve una máscara con un bit encendido por cada posición vacía del grupo.
+static inline uint32_t grupo_vacios(const int8_t *grupo){
+    return grupo_coincidencias(grupo, GRUPO_VACIO);
+}
+
+// Devuelve una máscara con un bit encendido por cada posición ocupada del grupo.
+static inline uint32_t grupo_ocupadas(const int8_t *grupo){
+    return ~grupo_libres(grupo) & ((1u << GRUPO_TAM) - 1);
+}
+
+#endif // GRUPO_H
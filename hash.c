@@ -1,450 +1,1513 @@
-#define _POSIX_C_SOURCE 200809L 
+#define _POSIX_C_SOURCE 200809L
 #include "hash.h"
-#include "lista.h"
+#include "arena.h"
+#include "grupo.h"
 #include <stdlib.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
 #include <string.h>
-
-#define BORRAR_NODO true
-#define AUMENTAR true
-#define FACTOR_CARGA 2
-#define CAPACIDAD_INICIAL 19
-#define CTE_AUMENTO 2
+#include <time.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/random.h>
+#endif
+
+#define FACTOR_CARGA_DEFECTO 0.875     // factor de carga máximo por defecto: 7/8
+#define FACTOR_CARGA_MINIMO 0.0625
+#define FACTOR_CARGA_MAXIMO 0.9375
+#define CARGA_ESCALA 1024               // el factor de carga se guarda como carga_maxima / CARGA_ESCALA
+#define CAPACIDAD_MINIMA 16
+#define CTE_AUMENTO 2                   // factor de crecimiento por defecto
+#define CRECIMIENTO_MAXIMO 256
 #define CTE_REDUCCION 2
-#define CRITERIO_REDUCCION 4
+#define CRITERIO_REDUCCION 2            // se reduce al borrar si la carga baja a la de recién crecido / 2...
+#define CARGA_TRAS_REDUCCION 2          // ...hasta la menor capacidad con carga de a lo sumo la máxima / 2
+#define TAM_GRUPO GRUPO_TAM
+#define POSICIONES_POR_MIGRACION 128    // posiciones de la tabla anterior que migra cada operación
+#define LARGO_CLAVE_INTERNA 24          // las claves de hasta 23 bytes se guardan dentro del campo
+#define TAM_LOTE 16                     // búsquedas cuyas lecturas de memoria se solapan en un lote
+
+#define VACIO GRUPO_VACIO
+#define BORRADO GRUPO_BORRADO
+#define H2_MASCARA GRUPO_H2_MASCARA
+
+#define IMAGEN_MAGIA "HASHIMG1"         // primeros bytes de una imagen (ver hash_serializar)
+#define IMAGEN_FUNCION_DEFECTO 0
+#define IMAGEN_FUNCION_DJB2 1
+#define IMAGEN_FUNCION_PROPIA 2
+#define IMAGEN_ALINEACION 8             // claves y datos empiezan en múltiplos de 8 bytes
+
+/* Contadores de instrumentación (ver hash_contadores en hash.h). Se compilan sólo
+con -DHASH_CONTADORES; si no, las macros no generan código. Se usan lecturas y
+escrituras atómicas relajadas en lugar de sumas atómicas: no necesitan el prefijo
+lock, y los lectores concurrentes de hash_concurrente no generan una carrera de
+datos, a lo sumo pierden alguna cuenta. */
+#ifdef HASH_CONTADORES
+#define CONTAR(contadores, campo, n) \
+    __atomic_store_n(&((hash_contadores_t*)(contadores))->campo, \
+                     __atomic_load_n(&(contadores)->campo, __ATOMIC_RELAXED) + (n), __ATOMIC_RELAXED)
+#define CRONOMETRO() reloj_ns()
+#define CRONOMETRAR_DESDE(contadores, inicio) CONTAR(contadores, nanosegundos_redimension, reloj_ns() - (inicio))
+#else
+#define CONTAR(contadores, campo, n) ((void)(n))
+#define CRONOMETRO() ((uint64_t) 0)
+#define CRONOMETRAR_DESDE(contadores, inicio) ((void)(inicio))
+#endif
 
 /* Definiciones previas:
-    Baldes: posiciones de un arreglo que contienen un puntero a una lista enlazada.
-            Los baldes tendrán índices del 0 a m (siendo m el largo del arreglo del hash).
-    
-    Listas: listas enlazadas apuntadas por el puntero del balde en un determinado índice.
-    Ej: balde en la posición 3 tiene un puntero que señala a una lista enlazada donde se encuentra, en cada nodo,
-        una clave (para la cual la función de hashing devolvió un 3) y su respectivo valor.
-
-    Iterador_hash: itera  el arreglo de baldes con punteros.
-    Iterador_lista: itera la lista enlazada que se encuentra dentro del balde elegido.
+    Posiciones: el hash guarda los campos directamente en un arreglo (direccionamiento abierto),
+            sin listas enlazadas. Las posiciones tendrán índices del 0 a m (siendo m la capacidad del hash).
+
+    Bytes de control: arreglo paralelo al de campos con un byte por posición. Vale VACIO, BORRADO,
+            o bien los 7 bits bajos del hash de la clave guardada (h2), que sirven de huella para
+            descartar posiciones sin tener que comparar la clave.
+
+    Grupos: bloques de TAM_GRUPO posiciones consecutivas. Los bits altos del hash (h1) eligen el
+            grupo inicial y, si la clave no está ahí, se sondea el siguiente grupo con saltos
+            triangulares (1, 2, 3...) que recorren todos los grupos porque su cantidad es potencia de 2.
+            La búsqueda termina en el primer grupo que tenga alguna posición VACIO.
+    Ej: una clave cuyo h1 cae en el grupo 3 se busca en las posiciones 48 a 63; si ninguna coincide
+        y el grupo no tiene vacíos, se continúa por el grupo 4, luego el 6, el 9...
+
+    Tablas: cada par de arreglos (control y campos) forma una tabla. Al redimensionar, el hash no
+            copia todo de una vez: la tabla actual pasa a ser la tabla anterior, se crea una tabla
+            actual vacía con la nueva capacidad, y cada hash_guardar/hash_borrar migra a lo sumo
+            POSICIONES_POR_MIGRACION posiciones de la anterior a la actual. Mientras dure la
+            migración, las búsquedas miran ambas tablas y las inserciones van a la actual.
+
+    Iterador_hash: recorre la tabla actual y luego la anterior, salteando las posiciones que no
+            están ocupadas.
 */
 
-/* Definición del struct campo */
+/* Definición del struct campo. Las claves cortas se copian dentro del campo;
+sólo las de LARGO_CLAVE_INTERNA bytes o más se piden aparte. */
 typedef struct campo {
-    char* clave;
+    union {
+        char interna[LARGO_CLAVE_INTERNA];
+        char* externa;
+    } clave;
+    size_t largo;           // largo de la clave, sin contar el '\0' final
     void* valor;
+    size_t num_hash;        // hash completo de la clave, para no recalcularlo
 } campo_t;
 
-/* Definición del struct hash */
-struct hash {
-    lista_t** baldes;
+/* Definición del struct tabla */
+typedef struct tabla {
+    int8_t* control;
+    campo_t* campos;
     size_t capacidad;
     size_t cantidad;
+    size_t borrados;
+    hash_contadores_t* contadores;  // los del hash al que pertenece la tabla
+} tabla_t;
+
+/* Definición del struct hash */
+struct hash {
+    tabla_t actual;
+    tabla_t anterior;       // capacidad 0 si no hay una migración en curso
+    size_t migradas;        // posiciones de la tabla anterior ya migradas
     void (*destruir_dato)(void*);
+    hash_funcion_t funcion;
+    uint64_t semilla;
+    arena_t* arena;         // de donde salen las copias de las claves; NULL para usar malloc
+    size_t carga_maxima;    // factor de carga máximo, en CARGA_ESCALA-avos
+    size_t crecimiento;     // por cuánto se multiplica la capacidad al crecer
+    size_t capacidad_minima;    // la inicial; el hash no se achica por debajo de ella
+    size_t redimensiones;
+    hash_contadores_t contadores;
 };
 
-/* Definicion del struct iterador hash */
-struct hash_iter{
-    const hash_t* hash;
-    size_t balde_actual;
-    lista_iter_t* balde_iter;
-    size_t iterados;
-};
+/* El struct iterador hash está definido en hash.h. Su campo tabla vale
+ITER_TABLA_ACTUAL o ITER_TABLA_ANTERIOR según qué tabla esté recorriendo. */
+#define ITER_TABLA_ACTUAL 0
+#define ITER_TABLA_ANTERIOR 1
 
 /***************************
-* Primitivas del Campo
+* Funciones auxiliares
 ****************************/
 
-/* Crea un campo.
-Pre: se le debe pasar una clave y un valor por parámetro.*/
-campo_t* campo_crear(char *clave, void *dato){
-    campo_t* campo = malloc(sizeof(campo_t));
+/* Constantes de mezcla de wyhash. */
+#define WY0 0xa0761d6478bd642fULL
+#define WY1 0xe7037ed1a0b428dbULL
+#define WY2 0x8ebc6af09c88c6e3ULL
+#define WY3 0x589965cc75374cc3ULL
 
-    if (campo == NULL) return NULL;
-    
-    campo->clave = clave;
-    campo->valor = dato;
+static inline uint64_t leer64(const uint8_t* p){
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
 
-    return campo;
+static inline uint64_t leer32(const uint8_t* p){
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
 }
-/* Destruye el campo.
-Pre: el campo debe haber sido creado.*/
-void campo_destruir(campo_t* campo){
-    free(campo->clave);
-    free(campo);
+
+/* Multiplica a y b en 128 bits y combina ambas mitades del resultado. */
+static inline uint64_t mezclar(uint64_t a, uint64_t b){
+    __extension__ unsigned __int128 r = (unsigned __int128)a * b;
+    return (uint64_t)r ^ (uint64_t)(r >> 64);
+}
+
+uint64_t hash_funcion_defecto(const void *clave, size_t largo, uint64_t semilla){
+    const uint8_t* p = clave;
+    uint64_t a, b;
+    semilla ^= mezclar(semilla ^ WY0, WY1);
+
+    if (largo <= 16){
+        if (largo >= 4){
+            size_t medio = (largo >> 3) << 2;
+            a = (leer32(p) << 32) | leer32(p + medio);
+            b = (leer32(p + largo - 4) << 32) | leer32(p + largo - 4 - medio);
+        } else if (largo > 0){
+            a = ((uint64_t)p[0] << 16) | ((uint64_t)p[largo >> 1] << 8) | p[largo - 1];
+            b = 0;
+        } else {
+            a = b = 0;
+        }
+    } else {
+        size_t restante = largo;
+        if (restante > 48){                 // tres cadenas independientes de 16 bytes
+            uint64_t semilla1 = semilla, semilla2 = semilla;
+            do {
+                semilla = mezclar(leer64(p) ^ WY1, leer64(p + 8) ^ semilla);
+                semilla1 = mezclar(leer64(p + 16) ^ WY2, leer64(p + 24) ^ semilla1);
+                semilla2 = mezclar(leer64(p + 32) ^ WY3, leer64(p + 40) ^ semilla2);
+                p += 48;
+                restante -= 48;
+            } while (restante > 48);
+            semilla ^= semilla1 ^ semilla2;
+        }
+        while (restante > 16){
+            semilla = mezclar(leer64(p) ^ WY1, leer64(p + 8) ^ semilla);
+            p += 16;
+            restante -= 16;
+        }
+        a = leer64(p + restante - 16);
+        b = leer64(p + restante - 8);
+    }
+
+    a ^= WY1;
+    b ^= semilla;
+    __extension__ unsigned __int128 r = (unsigned __int128)a * b;
+    return mezclar((uint64_t)r ^ WY0 ^ largo, (uint64_t)(r >> 64) ^ WY1);
+}
+
+uint64_t hash_funcion_djb2(const void *clave, size_t largo, uint64_t semilla){
+    const unsigned char* str = clave;
+    uint64_t hash = 5381 ^ semilla;
+
+    for (size_t i = 0; i < largo; i++)
+        hash = ((hash << 5) + hash) + str[i]; /* hash * 33 + c */
+
+    /* djb2 deja mal distribuidos los bits altos: se mezclan con el finalizador de MurmurHash3
+    para que tanto h1 como h2 sirvan con una capacidad potencia de 2. */
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ULL;
+    hash ^= hash >> 33;
+
+    return hash;
+}
+
+/* Pide la semilla al generador aleatorio del sistema operativo: getrandom donde
+existe, si no /dev/urandom. Devuelve false si ninguno de los dos respondió. */
+bool semilla_del_sistema(uint64_t* semilla){
+#ifdef __linux__
+    if (getrandom(semilla, sizeof(*semilla), GRND_NONBLOCK) == (ssize_t)sizeof(*semilla)) return true;
+#endif
+    int fd = open("/dev/urandom", O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return false;
+    bool ok = read(fd, semilla, sizeof(*semilla)) == (ssize_t)sizeof(*semilla);
+    close(fd);
+    return ok;
+}
+
+uint64_t hash_semilla_aleatoria(void){
+    uint64_t semilla;
+    if (semilla_del_sistema(&semilla)) return semilla;
+
+    // Sin generador del sistema, se mezclan el reloj, direcciones y un contador.
+    static uint64_t contador = 0;
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+
+    uint64_t entropia[3] = {
+        (uint64_t)ts.tv_sec ^ ((uint64_t)ts.tv_nsec << 32),
+        (uint64_t)(uintptr_t)&contador ^ (uint64_t)(uintptr_t)&ts,
+        __atomic_add_fetch(&contador, 1, __ATOMIC_RELAXED),
+    };
+    return hash_funcion_defecto(entropia, sizeof(entropia), WY2);
+}
+
+/* Aplica la función de hashing del hash a la clave. Devuelve el hash completo,
+sin reducir a la capacidad. */
+size_t funcion_hash(const hash_t* hash, const void *clave, size_t largo){
+    return (size_t)hash->funcion(clave, largo, hash->semilla);
+}
+
+/* Devuelve la clave guardada en el campo, esté dentro del campo o aparte. */
+const char* campo_clave(const campo_t* campo){
+    return campo->largo < LARGO_CLAVE_INTERNA ? campo->clave.interna : campo->clave.externa;
 }
 
 /***************************
-* Funciones auxiliares 
+* Primitivas de la Tabla
 ****************************/
 
-/* Función de hashing. Devuelve un número entre 0 y m (siendo m la capacidad del hash).
-Pre: recibe una clave y la cantidad del hash.*/
-size_t funcion_hash(const char *str, size_t cantidad) { //Utiliza el algoritmo 'djb2'
-    size_t hash = 5381;
-    int c;
-    
-    while ((c = *str++))
-        hash = ((hash << 5) + hash) + (unsigned long)c; /* hash * 33 + c */
-    
-    return hash%cantidad;
-}
-
-/* Devuelve el campo en el cual aparece la clave buscada.
-Pre: el hash debe haber sido creado. Se recibe por parámetro la variable bool borrar_nodo;
-si borrar_nodo es true, se borra el nodo en el que se encuentra el campo.
-La clave debe ser distinta de NULL.
-Post: dependiendo de bool borrar_nodo true o false, se borra o no el campo. */
-campo_t *_hash_obtener(const hash_t* hash, const char *clave, size_t indice_balde, bool borrar_nodo){
-
-    if (hash->capacidad == indice_balde){         // Si ya recorrí toda la lista
-        return NULL;
-    }
-    
-    lista_t* lista = hash->baldes[indice_balde];        // lista enlazada correspondiente a ese índice
-    if (!lista || lista_esta_vacia(lista)){
-        return NULL;
+/* Crea una tabla vacía con la capacidad recibida.
+Pre: la capacidad es potencia de 2 y múltiplo de TAM_GRUPO.
+Post: devuelve false si no se pudo pedir la memoria. */
+bool tabla_crear(tabla_t* tabla, size_t capacidad){
+    tabla->control = malloc(capacidad * sizeof(int8_t));
+    tabla->campos = malloc(capacidad * sizeof(campo_t));
+    if (!tabla->control || !tabla->campos){
+        free(tabla->control);
+        free(tabla->campos);
+        return false;
     }
-    lista_iter_t *iterador_lista = lista_iter_crear(lista);
-    if (!iterador_lista) return NULL;
-    
-    while (!lista_iter_al_final(iterador_lista)){
-        campo_t* campo = lista_iter_ver_actual(iterador_lista);
+    memset(tabla->control, VACIO, capacidad);
 
-        if (strcmp(campo->clave,clave) != 0){
-            lista_iter_avanzar(iterador_lista);
-            continue;
-        }
-        if (borrar_nodo){
-            campo = lista_iter_borrar(iterador_lista);
-        }
-        lista_iter_destruir(iterador_lista);
-        return campo;
-    }
-    lista_iter_destruir(iterador_lista);
-    return _hash_obtener(hash, clave, ++indice_balde, borrar_nodo);
-}
-
-/* Pre setea el arreglo tal que en todas sus 
-posiciones se encuentre NULL.
-Pre: El arreglo debe existir.
-Post: En todas sus posiciones hay NULL. */
-void pre_setear_arreglo(lista_t** lista, size_t n){
-    for (size_t i = 0; i < n; i++){
-        lista[i] = NULL;
-    }    
-}
-
-/* Transfiere los datos del arreglo del hash con la capacidad vieja
-a un nuevo arreglo de hash con la capacidad nueva pasada por parámetro,
-borrando los que se encuentran vacíos.
-Pre: el hash debe existir.
-Post: El hash tiene una nueva capacidad y se han eliminado
-los baldes vacíos.*/
-bool transferir_datos(hash_t* hash, size_t nueva_capacidad){
-    lista_t** baldes = malloc(sizeof(lista_t*)*nueva_capacidad);
-    if (!baldes) return false;
-    pre_setear_arreglo(baldes,nueva_capacidad);
-    
-    for (size_t i = 0; i < hash->capacidad; i++){
-        lista_t* lista_hash_orig = hash->baldes[i];
-
-        if (lista_hash_orig == NULL){
-            continue;
+    tabla->capacidad = capacidad;
+    tabla->cantidad = 0;
+    tabla->borrados = 0;
+    return true;
+}
+
+/* Libera los arreglos de la tabla (no las claves) y la deja con capacidad 0. */
+void tabla_destruir(tabla_t* tabla){
+    free(tabla->control);
+    free(tabla->campos);
+    tabla->control = NULL;
+    tabla->campos = NULL;
+    tabla->capacidad = 0;
+    tabla->cantidad = 0;
+    tabla->borrados = 0;
+}
+
+/* Devuelve la posición de la tabla en la que se encuentra la clave buscada, o la
+capacidad de la tabla si no está. Sólo se inspeccionan los grupos de la secuencia
+de sondeo de la clave.
+Si libre no es NULL, en el mismo recorrido se guarda en *libre la primera posición
+VACIO o BORRADO de la secuencia (la misma que devolvería tabla_buscar_libre), o la
+capacidad si la clave se encontró antes de pasar por una.
+Pre: la tabla tiene capacidad mayor a 0. La clave debe ser distinta de NULL. */
+size_t tabla_buscar(const tabla_t* tabla, const void *clave, size_t largo, size_t num_hash, size_t* libre){
+    size_t mascara = tabla->capacidad / TAM_GRUPO - 1;
+    size_t grupo = (num_hash >> 7) & mascara;
+    int8_t h2 = (int8_t)(num_hash & H2_MASCARA);
+    if (libre) *libre = tabla->capacidad;
+    size_t comparaciones = 0;
+
+    for (size_t salto = 1; salto <= mascara + 1; salto++){
+        const int8_t* control = tabla->control + grupo * TAM_GRUPO;
+        uint32_t coincidencias = grupo_coincidencias(control, h2);
+        CONTAR(tabla->contadores, grupos_sondeados, 1);
+
+        if (libre && *libre == tabla->capacidad){
+            uint32_t libres = grupo_libres(control);
+            if (libres) *libre = grupo * TAM_GRUPO + (size_t)__builtin_ctz(libres);
         }
-        lista_iter_t * iterador_lista = lista_iter_crear(lista_hash_orig);
-        
-        while (!lista_iter_al_final(iterador_lista)){
-            campo_t* campo = lista_iter_ver_actual(iterador_lista);                
-            size_t num_hash = funcion_hash(campo->clave,nueva_capacidad);
-
-            if (baldes[num_hash] == NULL){
-                baldes[num_hash] = lista_crear();
-            }
 
-            lista_insertar_ultimo(baldes[num_hash],campo);
-            lista_iter_borrar(iterador_lista);
+        while (coincidencias){
+            size_t posicion = grupo * TAM_GRUPO + (size_t)__builtin_ctz(coincidencias);
+            const campo_t* campo = &tabla->campos[posicion];
+            comparaciones++;
+            if (campo->num_hash == num_hash && campo->largo == largo &&
+                memcmp(campo_clave(campo), clave, largo) == 0){
+                CONTAR(tabla->contadores, comparaciones, comparaciones);
+                return posicion;
+            }
+            coincidencias &= coincidencias - 1;
         }
-        lista_iter_destruir(iterador_lista);
-        lista_destruir(lista_hash_orig,NULL);
+        if (grupo_vacios(control)) break;       // la clave habría quedado en este grupo
+        grupo = (grupo + salto) & mascara;
     }
-    
-    free(hash->baldes);
-    hash->baldes = baldes;
+    CONTAR(tabla->contadores, comparaciones, comparaciones);
+    return tabla->capacidad;
+}
 
-    return true;
+/* Pide al procesador que traiga a caché los bytes de control del primer grupo de la
+secuencia de sondeo de num_hash, sin esperar a que lleguen. */
+void tabla_precargar_control(const tabla_t* tabla, size_t num_hash){
+    size_t mascara = tabla->capacidad / TAM_GRUPO - 1;
+    __builtin_prefetch(tabla->control + ((num_hash >> 7) & mascara) * TAM_GRUPO);
 }
 
-/* Redimensiona la capacidad del hash.
-Pre: el hash debe haber sido creado.
-Post: El hash tiene una nueva capacidad que es un número primo. */
-bool hash_redimensionar_capacidad(hash_t *hash, size_t (*operacion) (hash_t*, size_t*, size_t)){
-    size_t primos[] = {2, 3, 5, 7, 11 , 13, 17 ,19, 23, 29, 31, 37};
-    size_t n = 12;
-    size_t nueva_capacidad = (*operacion)(hash, primos, n);
+/* Pide al procesador que traiga a caché el campo del primer grupo cuya huella
+coincide con la de num_hash, que es donde muy probablemente esté la clave. */
+void tabla_precargar_campo(const tabla_t* tabla, size_t num_hash){
+    size_t mascara = tabla->capacidad / TAM_GRUPO - 1;
+    size_t inicio = ((num_hash >> 7) & mascara) * TAM_GRUPO;
+    uint32_t coincidencias = grupo_coincidencias(tabla->control + inicio, (int8_t)(num_hash & H2_MASCARA));
+    if (coincidencias) __builtin_prefetch(tabla->campos + inicio + __builtin_ctz(coincidencias));
+}
+
+/* Devuelve la primera posición VACIO o BORRADO de la secuencia de sondeo de num_hash.
+Pre: la tabla tiene al menos una posición libre (lo garantiza el factor de carga). */
+size_t tabla_buscar_libre(const tabla_t* tabla, size_t num_hash){
+    size_t mascara = tabla->capacidad / TAM_GRUPO - 1;
+    size_t grupo = (num_hash >> 7) & mascara;
 
-    if (transferir_datos(hash, nueva_capacidad)){
-        hash->capacidad = nueva_capacidad;
-        return true;
+    for (size_t salto = 1; ; salto++){
+        uint32_t libres = grupo_libres(tabla->control + grupo * TAM_GRUPO);
+        if (libres) return grupo * TAM_GRUPO + (size_t)__builtin_ctz(libres);
+        grupo = (grupo + salto) & mascara;
     }
-    return false;
 }
 
-/*Busca y devuelve el numero primo mas cercano a otro numero mayor o igual a 41.
-Pre: recibe un numero mayor o igual a 41 en caso de que la condicion sea 'false', mayor estricto en caso de 'true';
-*/
-size_t busqueda_mayores(size_t buscado,size_t inicio,size_t fin,bool condicion){
-    size_t m = inicio + ((fin-inicio)/2);
-    size_t actual = (m*m) + m + 41;                 // formula para conseguir primos desde el 41 hasta el 1601 (Wikipedia)
-    size_t anterior = (m-1*m-1) + m-1 + 41;
+/* Guarda el campo en la posición indicada, que debe estar libre. */
+void tabla_ocupar(tabla_t* tabla, size_t posicion, campo_t campo){
+    if (tabla->control[posicion] == BORRADO) tabla->borrados--;
+    tabla->control[posicion] = (int8_t)(campo.num_hash & H2_MASCARA);
+    tabla->campos[posicion] = campo;
+    tabla->cantidad++;
+}
 
-    if (actual < buscado){
-        return busqueda_mayores(buscado,m+1,fin,condicion);
+/* Libera la posición indicada, que debe estar ocupada. No libera la clave. */
+void tabla_liberar(tabla_t* tabla, size_t posicion){
+    /* Si el grupo tiene algún vacío, ninguna búsqueda pudo haber seguido de largo por él
+    y la posición puede volver a quedar VACIO; si no, se deja una marca de BORRADO. */
+    const int8_t* grupo = tabla->control + (posicion - posicion % TAM_GRUPO);
+    if (grupo_vacios(grupo)){
+        tabla->control[posicion] = VACIO;
+    } else {
+        tabla->control[posicion] = BORRADO;
+        tabla->borrados++;
     }
-    if (anterior < buscado){
-        return condicion ? actual : anterior;
+    tabla->cantidad--;
+}
+
+/* Devuelve cuántos grupos recorre la búsqueda de la clave guardada en la posición
+indicada: 1 si está en el primer grupo de su secuencia de sondeo, 2 si en el
+segundo, etc.
+Pre: la posición está ocupada. */
+size_t tabla_largo_sondeo(const tabla_t* tabla, size_t posicion){
+    size_t mascara = tabla->capacidad / TAM_GRUPO - 1;
+    size_t grupo = (tabla->campos[posicion].num_hash >> 7) & mascara;
+    size_t largo = 1;
+
+    for (size_t salto = 1; grupo != posicion / TAM_GRUPO && salto <= mascara; salto++){
+        grupo = (grupo + salto) & mascara;
+        largo++;
     }
-    return busqueda_mayores(buscado,inicio,m,condicion);
+    return largo;
 }
 
-/*Busca y devuelve el numero primo mas cercano a otro numero menor a 37.
-Pre: Recibe un arreglo ordenado de numeros primos menores a 41 y un numero menor a 37.
-*/
-size_t busqueda_menores(size_t buscado, size_t* arreglo, size_t inicio, size_t fin, bool condicion){
-    size_t m = inicio + ( (fin-inicio)/2);
-    size_t actual = arreglo[m];
-    size_t anterior = arreglo[m-1];
+/* Devuelve la primera posición ocupada a partir de inicio, o la capacidad si no hay ninguna. */
+size_t tabla_siguiente_ocupada(const tabla_t* tabla, size_t inicio){
+    // Con la tabla cargada lo común es que la siguiente posición ya esté ocupada.
+    if (inicio < tabla->capacidad && tabla->control[inicio] >= 0) return inicio;
+
+    while (inicio < tabla->capacidad){
+        size_t grupo = inicio - inicio % TAM_GRUPO;
+        uint32_t ocupadas = grupo_ocupadas(tabla->control + grupo) >> (inicio - grupo);
+        if (ocupadas) return inicio + (size_t)__builtin_ctz(ocupadas);
+        inicio = grupo + TAM_GRUPO;
+    }
+    return tabla->capacidad;
+}
+
+/***************************
+* Funciones auxiliares del Hash
+****************************/
+
+/* Devuelve el valor de un reloj monótono, en nanosegundos. */
+static inline uint64_t reloj_ns(void){
+    struct timespec tiempo;
+    clock_gettime(CLOCK_MONOTONIC, &tiempo);
+    return (uint64_t) tiempo.tv_sec * 1000000000u + (uint64_t) tiempo.tv_nsec;
+}
+
+/* Registra en los contadores del hash una consulta y si se encontró la clave. */
+static inline void hash_contar_consulta(const hash_t* hash, bool encontrada){
+    CONTAR(&hash->contadores, consultas, 1);
+    CONTAR(&hash->contadores, aciertos, encontrada);
+    CONTAR(&hash->contadores, fallos, !encontrada);
+}
+
+/* Devuelve true si hay una migración en curso. */
+bool hash_migrando(const hash_t* hash){
+    return hash->anterior.capacidad > 0;
+}
+
+/* Busca la clave en la tabla actual y, si hay una migración en curso, en la anterior.
+Devuelve la tabla en la que se encuentra y guarda su posición en *posicion, o NULL
+si la clave no está.
+Pre: el hash debe haber sido creado. La clave debe ser distinta de NULL. */
+tabla_t *_hash_obtener(const hash_t* hash, const void *clave, size_t largo, size_t num_hash, size_t* posicion){
+    tabla_t* tabla = (tabla_t*)&hash->actual;
+    *posicion = tabla_buscar(tabla, clave, largo, num_hash, NULL);
+    if (*posicion != tabla->capacidad) return tabla;
+
+    if (!hash_migrando(hash)) return NULL;
+
+    tabla = (tabla_t*)&hash->anterior;
+    *posicion = tabla_buscar(tabla, clave, largo, num_hash, NULL);
+    return *posicion != tabla->capacidad ? tabla : NULL;
+}
+
+/* Migra a la tabla actual los campos de hasta 'posiciones' posiciones de la tabla
+anterior, usando el hash guardado en cada campo. Las posiciones migradas quedan
+libres en la anterior, de modo que las búsquedas que todavía la recorren siguen
+funcionando. Cuando se migró toda la anterior, se la destruye.
+Pre: el hash debe haber sido creado.
+Post: si no quedan campos en la anterior, no hay migración en curso. */
+void hash_migrar(hash_t* hash, size_t posiciones){
+    if (!hash_migrando(hash)) return;
+
+    uint64_t inicio = CRONOMETRO();
+    tabla_t* anterior = &hash->anterior;
+    tabla_t* actual = &hash->actual;
+    size_t fin = hash->migradas + posiciones;
+    if (fin > anterior->capacidad || fin < hash->migradas) fin = anterior->capacidad;
+
+    for (size_t i = hash->migradas; i < fin && anterior->cantidad > 0; i++){
+        if (anterior->control[i] < 0) continue;         // VACIO o BORRADO
+
+        campo_t campo = anterior->campos[i];
+        tabla_ocupar(actual, tabla_buscar_libre(actual, campo.num_hash), campo);
+        tabla_liberar(anterior, i);
+    }
+    hash->migradas = fin;
 
-    if (actual < buscado){
-        return busqueda_menores(buscado,arreglo,m+1,fin,condicion);
+    if (anterior->cantidad == 0){
+        tabla_destruir(anterior);
+        hash->migradas = 0;
     }
-    if (anterior < buscado){
-        return condicion ? actual : anterior;
+    CRONOMETRAR_DESDE(&hash->contadores, inicio);
+}
+
+/* Empieza la migración a una tabla actual vacía de la capacidad recibida.
+Pre: no hay una migración en curso. La capacidad es potencia de 2, múltiplo de
+TAM_GRUPO y alcanza para todos los elementos del hash.
+Post: devuelve false si no hay memoria, sin modificar el hash. */
+bool hash_redimensionar_a(hash_t *hash, size_t nueva_capacidad){
+    uint64_t inicio = CRONOMETRO();
+    tabla_t nueva;
+    if (!tabla_crear(&nueva, nueva_capacidad)) return false;
+    nueva.contadores = &hash->contadores;
+
+    hash->anterior = hash->actual;
+    hash->actual = nueva;
+    hash->migradas = 0;
+    hash->redimensiones++;
+    if (hash->anterior.cantidad == 0) tabla_destruir(&hash->anterior);
+    CRONOMETRAR_DESDE(&hash->contadores, inicio);
+    return true;
+}
+
+/* Devuelve true si 'ocupadas' posiciones de una tabla de la capacidad recibida
+superan el factor de carga máximo del hash. */
+static inline bool hash_excede_carga(const hash_t *hash, size_t ocupadas, size_t capacidad){
+    return ocupadas * CARGA_ESCALA > capacidad * hash->carga_maxima;
+}
+
+/* Aumenta la capacidad. Si la mayoría de las posiciones ocupadas son borrados,
+conserva la capacidad: alcanza con reacomodar para eliminarlos.
+La capacidad crece sin otro límite que el tamaño direccionable: devuelve 0 si
+aumentarla desbordaría el tamaño del arreglo de campos. */
+size_t aumentar_capacidad(const hash_t *hash){
+    const tabla_t* tabla = &hash->actual;
+    if (tabla->borrados > tabla->cantidad) return tabla->capacidad;
+    if (tabla->capacidad > SIZE_MAX / hash->crecimiento / sizeof(campo_t)) return 0;
+    return tabla->capacidad * hash->crecimiento;
+}
+
+/* Devuelve la menor capacidad válida (potencia de 2, de al menos CAPACIDAD_MINIMA)
+en la que entran 'cantidad' elementos sin superar el factor de carga, o 0 si no
+hay ninguna. */
+size_t capacidad_para(const hash_t *hash, size_t cantidad){
+    if (cantidad > SIZE_MAX / CARGA_ESCALA) return 0;
+
+    size_t capacidad = CAPACIDAD_MINIMA;
+    while (hash_excede_carga(hash, cantidad, capacidad)){
+        if (capacidad > SIZE_MAX / 2 / sizeof(campo_t)) return 0;
+        capacidad *= 2;
     }
-    return busqueda_menores(buscado,arreglo,inicio,m,condicion);
+    return capacidad;
 }
 
-/* Aumenta la capacidad buscando el número primo correspondiente. */
-size_t aumentar_capacidad(hash_t *hash, size_t *primos, size_t n){
-    size_t capacidad = hash->capacidad*CTE_AUMENTO;
+/* Devuelve true si, después de un borrado, la carga del hash bajó tanto que
+conviene achicarlo: a la mitad de la que queda justo después de crecer. */
+bool hash_debe_reducirse(const hash_t *hash){
+    const tabla_t* actual = &hash->actual;
+    return !hash_migrando(hash) && actual->capacidad > hash->capacidad_minima &&
+           !hash_excede_carga(hash, actual->cantidad * hash->crecimiento * CRITERIO_REDUCCION, actual->capacidad);
+}
 
-    if (capacidad <= primos[n-1]){
-        return busqueda_menores(capacidad,primos,0,n,AUMENTAR);
+/* Disminuye la capacidad sin bajar de la capacidad inicial. Si se borraron
+muchos elementos de una vez, reduce varias veces en un solo paso hasta la menor
+capacidad en la que los elementos quedan a lo sumo a 1/CARGA_TRAS_REDUCCION del
+factor de carga máximo. Como la carga resultante queda lejos tanto del criterio
+de reducción como del factor de carga máximo, un hash cuya cantidad oscila
+alrededor de un umbral no crece y se achica una y otra vez. */
+size_t reducir_capacidad(const hash_t *hash){
+    size_t cantidad = hash_cantidad(hash);
+    size_t capacidad = hash->actual.capacidad / CTE_REDUCCION;
+    while (capacidad / CTE_REDUCCION >= hash->capacidad_minima &&
+           !hash_excede_carga(hash, cantidad * CARGA_TRAS_REDUCCION, capacidad / CTE_REDUCCION)){
+        capacidad /= CTE_REDUCCION;
     }
-    if (capacidad > 41){
-        return busqueda_mayores(capacidad,0,40,AUMENTAR);
+    return capacidad < hash->capacidad_minima ? hash->capacidad_minima : capacidad;
+}
+
+/* Pasa en el momento todos los campos de la tabla actual y de la anterior a una
+tabla nueva de la capacidad recibida, que queda como tabla actual, sin migración
+en curso.
+Pre: la capacidad es potencia de 2, múltiplo de TAM_GRUPO y alcanza para todos
+los elementos del hash.
+Post: devuelve false si no hay memoria, sin modificar el hash. */
+bool hash_reconstruir(hash_t *hash, size_t nueva_capacidad){
+    uint64_t inicio = CRONOMETRO();
+    tabla_t nueva;
+    if (!tabla_crear(&nueva, nueva_capacidad)) return false;
+    nueva.contadores = &hash->contadores;
+
+    tabla_t* tablas[] = {&hash->actual, &hash->anterior};
+    for (size_t t = 0; t < 2; t++){
+        tabla_t* tabla = tablas[t];
+        for (size_t i = 0; i < tabla->capacidad; i++){
+            if (tabla->control[i] < 0) continue;        // VACIO o BORRADO
+            campo_t campo = tabla->campos[i];
+            tabla_ocupar(&nueva, tabla_buscar_libre(&nueva, campo.num_hash), campo);
+        }
+        tabla_destruir(tabla);
     }
-    return 41;
+    hash->actual = nueva;
+    hash->migradas = 0;
+    hash->redimensiones++;
+    CRONOMETRAR_DESDE(&hash->contadores, inicio);
+    return true;
 }
 
-/* Disminuye la capacidad buscando el número primo correspondiente. */
-size_t reducir_capacidad(hash_t *hash, size_t *primos, size_t n){
-    size_t capacidad = hash->capacidad/CTE_REDUCCION;
+/* Termina la migración en curso, si la hay. Si la tabla actual no tiene lugar
+para lo que queda en la anterior, todo pasa a una tabla en la que sí entra.
+Post: devuelve false si no hay memoria, sin modificar el hash; si no, no hay
+migración en curso. */
+bool hash_terminar_migracion(hash_t *hash){
+    tabla_t* actual = &hash->actual;
+    if (hash_migrando(hash) &&
+        hash_excede_carga(hash, hash_cantidad(hash) + actual->borrados, actual->capacidad)){
+        size_t capacidad = capacidad_para(hash, hash_cantidad(hash));
+        if (capacidad < actual->capacidad) capacidad = actual->capacidad;
+        if (capacidad == 0 || !hash_reconstruir(hash, capacidad)) return false;
+    }
+    hash_migrar(hash, SIZE_MAX);
+    return true;
+}
 
-    if (capacidad <= primos[n-1]){
-        return busqueda_menores(capacidad,primos,0,n,!AUMENTAR);
+/* Redimensiona la capacidad del hash. Si había una migración en curso se la
+completa primero; luego la tabla actual pasa a ser la anterior y se crea una
+tabla actual vacía, que se irá llenando de a poco con hash_migrar.
+Si la tabla actual no tiene lugar para lo que queda en la anterior (puede pasar
+si el hash se achicó varias veces de golpe y volvió a crecer antes de terminar
+de migrar), no se migra a ella: todo pasa directamente a una tabla de la nueva
+capacidad, o de la menor en la que entren todos los elementos si es mayor.
+Pre: el hash debe haber sido creado.
+Post: El hash tiene la capacidad que devuelve la operación. Si la operación
+devuelve 0 (no hay capacidad posible) o no hay memoria, el hash no cambia
+de capacidad y se devuelve false. */
+bool hash_redimensionar_capacidad(hash_t *hash, size_t (*operacion) (const hash_t*)){
+    tabla_t* actual = &hash->actual;
+    if (hash_migrando(hash) &&
+        hash_excede_carga(hash, hash_cantidad(hash) + actual->borrados, actual->capacidad)){
+        size_t nueva_capacidad = (*operacion)(hash);
+        size_t necesaria = capacidad_para(hash, hash_cantidad(hash));
+        if (nueva_capacidad == 0 || necesaria == 0) return false;
+        return hash_reconstruir(hash, nueva_capacidad > necesaria ? nueva_capacidad : necesaria);
+    }
+    hash_migrar(hash, SIZE_MAX);
+
+    size_t nueva_capacidad = (*operacion)(hash);
+    if (nueva_capacidad == 0) return false;
+
+    return hash_redimensionar_a(hash, nueva_capacidad);
+}
+
+/* Devuelve la tabla que está recorriendo el iterador. */
+const tabla_t* hash_iter_tabla(const hash_iter_t* iter){
+    return iter->tabla == ITER_TABLA_ACTUAL ? &iter->hash->actual : &iter->hash->anterior;
+}
+
+/* Lleva el iterador a la siguiente posición ocupada a partir de la suya, pasando
+de la tabla actual a la anterior cuando termina de recorrer la primera. */
+void hash_iter_acomodar(hash_iter_t* iter){
+    const tabla_t* tabla = hash_iter_tabla(iter);
+    iter->posicion = tabla_siguiente_ocupada(tabla, iter->posicion);
+    if (iter->posicion < tabla->capacidad) return;
+
+    if (iter->tabla == ITER_TABLA_ACTUAL && hash_migrando(iter->hash)){
+        iter->tabla = ITER_TABLA_ANTERIOR;
+        iter->posicion = tabla_siguiente_ocupada(&iter->hash->anterior, 0);
     }
-    if (capacidad > 41){
-        return busqueda_mayores(capacidad,0,40,!AUMENTAR);
+}
+
+/* Copia la clave en el campo, terminada en '\0'. Si es larga, la copia se pide
+a la arena del hash o, si no tiene una, a malloc. Devuelve false si no hay memoria. */
+bool hash_copiar_clave(hash_t* hash, campo_t* campo, const void* clave, size_t largo){
+    char* copia = campo->clave.interna;
+
+    if (largo >= LARGO_CLAVE_INTERNA){
+        copia = hash->arena ? arena_pedir(hash->arena, largo + 1) : malloc(largo + 1);
+        if (copia == NULL) return false;
+        campo->clave.externa = copia;
     }
-    return primos[n-1];
+    memcpy(copia, clave, largo);
+    copia[largo] = '\0';
+    campo->largo = largo;
+    return true;
 }
 
-/* Crea un iterador a partir de la primer lista no vacía que se encuentre
-en el arreglo del hash. 
-Pre: el hash debe haber sido creado. 
-Post: se devuelve un iterador inicializado en una lista del hash. */
-lista_iter_t* hash_iter_crear_balde_iter(hash_iter_t* iter){
-    lista_t** baldes = iter->hash->baldes;
-    size_t* actual = &(iter->balde_actual);
+/* Libera la copia de la clave del campo, si se había pedido aparte. */
+void hash_liberar_clave(hash_t* hash, campo_t* campo){
+    if (campo->largo < LARGO_CLAVE_INTERNA) return;
+
+    if (hash->arena == NULL){
+        free(campo->clave.externa);
+        return;
+    }
+    arena_liberar(hash->arena, campo->clave.externa, campo->largo + 1);
+}
+
+/* Guarda en la posición libre indicada de la tabla actual una clave que no está
+en el hash, y devuelve su campo.
+Pre: la posición es la primera libre de la secuencia de sondeo de num_hash en la
+tabla actual, que tiene lugar para un elemento más sin superar el factor de carga.
+Post: devuelve NULL si no se pudo copiar la clave. */
+campo_t *hash_insertar_nuevo(hash_t* hash, size_t posicion, const void* clave, size_t largo,
+                             size_t num_hash, void* dato){
+    campo_t campo;
+    if (!hash_copiar_clave(hash, &campo, clave, largo)) return NULL;
+
+    campo.valor = dato;
+    campo.num_hash = num_hash;
+    tabla_ocupar(&hash->actual, posicion, campo);
+    return &hash->actual.campos[posicion];
+}
 
-    if (hash_cantidad(iter->hash) == 0) return NULL;
+/* Devuelve el campo de la clave, guardándola con dato_inicial si no estaba. La
+secuencia de sondeo de la tabla actual se recorre una sola vez: al buscar la
+clave se anota la primera posición libre, que es donde se la inserta si no
+aparece. Sólo si la clave es nueva se mira el factor de carga, así que
+encontrarla o reemplazar su valor nunca redimensiona. *insertada indica si la
+clave es nueva.
+Pre: num_hash es el hash de la clave.
+Post: devuelve NULL si no hay memoria, sin modificar los elementos del hash. */
+campo_t *hash_buscar_o_insertar(hash_t* hash, const void* clave, size_t largo,
+                                size_t num_hash, void* dato_inicial, bool* insertada){
+    hash_migrar(hash, POSICIONES_POR_MIGRACION);
+
+    tabla_t* actual = &hash->actual;
+    size_t libre;
+    size_t posicion = tabla_buscar(actual, clave, largo, num_hash, &libre);
+    *insertada = false;
+    if (posicion != actual->capacidad) return &actual->campos[posicion];
+
+    if (hash_migrando(hash)){
+        tabla_t* anterior = &hash->anterior;
+        posicion = tabla_buscar(anterior, clave, largo, num_hash, NULL);
+        if (posicion != anterior->capacidad) return &anterior->campos[posicion];
+    }
 
-    while (baldes[*actual] == NULL){
-        (*actual)++;
+    // Se cuentan también los elementos que quedan en la anterior: todos van a
+    // terminar en la actual, y si no entran hash_migrar no termina nunca.
+    if (hash_excede_carga(hash, hash_cantidad(hash) + actual->borrados + 1, actual->capacidad)){
+        if (!hash_redimensionar_capacidad(hash,aumentar_capacidad)) return NULL;
+        hash_migrar(hash, POSICIONES_POR_MIGRACION);
+        libre = tabla_buscar_libre(actual, num_hash);
     }
 
-    lista_iter_t* balde_iter = lista_iter_crear(baldes[*actual]);
+    campo_t* campo = hash_insertar_nuevo(hash, libre, clave, largo, num_hash, dato_inicial);
+    *insertada = campo != NULL;
+    CONTAR(&hash->contadores, inserciones, *insertada);
+    return campo;
+}
+
+/* Guarda un lote de pares. Reserva lugar para todos de una vez, de modo que el
+hash no crece a mitad de camino, y calcula los hashes de a TAM_LOTE claves
+precargando sus grupos antes de insertarlas. Si claves_unicas es true no busca
+cada clave antes de insertarla.
+Si largos es NULL las claves son cadenas terminadas en '\0'. */
+bool _hash_guardar_lote(hash_t *hash, const void *const *claves, const size_t *largos,
+                        void *const *datos, size_t cantidad, bool claves_unicas){
+    if (!hash_reservar(hash, hash_cantidad(hash) + cantidad)) return false;
+
+    size_t num_hash[TAM_LOTE];
+    size_t largo[TAM_LOTE];
+
+    for (size_t inicio = 0; inicio < cantidad; inicio += TAM_LOTE){
+        size_t fin = cantidad - inicio < TAM_LOTE ? cantidad - inicio : TAM_LOTE;
+
+        for (size_t i = 0; i < fin; i++){
+            const void* clave = claves[inicio + i];
+            largo[i] = largos ? largos[inicio + i] : strlen(clave);
+            num_hash[i] = funcion_hash(hash, clave, largo[i]);
+            tabla_precargar_control(&hash->actual, num_hash[i]);
+        }
+
+        for (size_t i = 0; i < fin; i++){
+            const void* clave = claves[inicio + i];
+            void* dato = datos[inicio + i];
+
+            /* Reservar dejó todo en la tabla actual, sin migración en curso */
+            size_t posicion = hash->actual.capacidad;
+            size_t libre;
+            if (claves_unicas){
+                libre = tabla_buscar_libre(&hash->actual, num_hash[i]);
+            } else {
+                posicion = tabla_buscar(&hash->actual, clave, largo[i], num_hash[i], &libre);
+            }
 
-    return balde_iter;
+            if (posicion != hash->actual.capacidad){            // la clave ya estaba
+                campo_t* campo = &hash->actual.campos[posicion];
+                if (hash->destruir_dato) hash->destruir_dato(campo->valor);
+                campo->valor = dato;
+                CONTAR(&hash->contadores, reemplazos, 1);
+                continue;
+            }
+            if (!hash_insertar_nuevo(hash, libre, clave, largo[i], num_hash[i], dato)) return false;
+            CONTAR(&hash->contadores, inserciones, 1);
+        }
+    }
+    return true;
 }
 
 /***************************
 * Primitivas del Hash
 ****************************/
 
+hash_config_t hash_config_defecto(void){
+    hash_config_t config = {
+        .capacidad_inicial = 0,
+        .factor_carga = FACTOR_CARGA_DEFECTO,
+        .factor_crecimiento = CTE_AUMENTO,
+        .funcion = NULL,
+        .semilla = hash_semilla_aleatoria(),
+        .usar_arena = false,
+    };
+    return config;
+}
+
 hash_t *hash_crear(void (*destruir_dato)(void*)){
+    hash_config_t config = hash_config_defecto();
+    return hash_crear_con_config(destruir_dato, &config);
+}
+
+hash_t *hash_crear_con_funcion(hash_destruir_dato_t destruir_dato, hash_funcion_t funcion, uint64_t semilla){
+    hash_config_t config = hash_config_defecto();
+    config.funcion = funcion;
+    config.semilla = semilla;
+    return hash_crear_con_config(destruir_dato, &config);
+}
+
+hash_t *hash_crear_con_arena(hash_destruir_dato_t destruir_dato){
+    hash_config_t config = hash_config_defecto();
+    config.usar_arena = true;
+    return hash_crear_con_config(destruir_dato, &config);
+}
+
+hash_t *hash_crear_con_config(hash_destruir_dato_t destruir_dato, const hash_config_t *config){
+    size_t crecimiento = config->factor_crecimiento;
+    if (!(config->factor_carga >= FACTOR_CARGA_MINIMO && config->factor_carga <= FACTOR_CARGA_MAXIMO) ||
+        crecimiento < 2 || crecimiento > CRECIMIENTO_MAXIMO || (crecimiento & (crecimiento - 1)) != 0){
+        return NULL;
+    }
+
     hash_t* hash = malloc(sizeof(hash_t));
     if (!hash){
         return NULL;
     }
+    hash->carga_maxima = (size_t)(config->factor_carga * CARGA_ESCALA);
+    hash->crecimiento = crecimiento;
 
-    lista_t** baldes = malloc(CAPACIDAD_INICIAL * sizeof(lista_t*));
-    if (!baldes){
+    hash->capacidad_minima = capacidad_para(hash, config->capacidad_inicial);
+    if (hash->capacidad_minima == 0 || !tabla_crear(&hash->actual, hash->capacidad_minima)){
+        free(hash);
         return NULL;
     }
-    hash->baldes = baldes;
-    pre_setear_arreglo(hash->baldes,CAPACIDAD_INICIAL);
+    hash->anterior = (tabla_t){NULL, NULL, 0, 0, 0, NULL};
+    hash->migradas = 0;
+    hash->redimensiones = 0;
+    hash->contadores = (hash_contadores_t){0};
+    hash->actual.contadores = &hash->contadores;
 
-    hash->capacidad = CAPACIDAD_INICIAL;
-    hash->cantidad = 0;
     hash->destruir_dato = destruir_dato;
+    hash->funcion = config->funcion ? config->funcion : hash_funcion_defecto;
+    hash->semilla = config->semilla;
+    hash->arena = NULL;
+
+    if (config->usar_arena){
+        hash->arena = arena_crear();
+        if (!hash->arena){
+            hash_destruir(hash);
+            return NULL;
+        }
+    }
     return hash;
 }
 
 bool hash_guardar(hash_t *hash, const char *clave, void *dato){
-    if ((hash->cantidad / hash->capacidad) >= FACTOR_CARGA){
-        if (!hash_redimensionar_capacidad(hash,aumentar_capacidad)) return false;
-    } 
+    return hash_guardar_n(hash, clave, strlen(clave), dato);
+}
+
+bool hash_guardar_n(hash_t *hash, const void *clave, size_t largo, void *dato){
+    return hash_guardar_con_hash(hash, clave, largo, funcion_hash(hash, clave, largo), dato);
+}
 
-    size_t num_hash = funcion_hash(clave,hash->capacidad);
-    campo_t* campo = _hash_obtener(hash,clave,num_hash,!BORRAR_NODO);
+bool hash_guardar_con_hash(hash_t *hash, const void *clave, size_t largo, uint64_t num_hash, void *dato){
+    bool insertada;
+    campo_t* campo = hash_buscar_o_insertar(hash, clave, largo, (size_t)num_hash, dato, &insertada);
+    if (campo == NULL) return false;
 
-    if (campo != NULL){             // Si se desea actualizar el valor de una clave
+    if (!insertada){             // Si se desea actualizar el valor de una clave
         if (hash->destruir_dato) hash->destruir_dato(campo->valor);
         campo->valor = dato;
-        return true;
+        CONTAR(&hash->contadores, reemplazos, 1);
     }
+    return true;
+}
 
-    char* copia_clave = strdup(clave);
+void **hash_obtener_o_insertar(hash_t *hash, const char *clave, void *dato_inicial){
+    return hash_obtener_o_insertar_n(hash, clave, strlen(clave), dato_inicial);
+}
 
-    if (copia_clave == NULL) return false;
+void **hash_obtener_o_insertar_n(hash_t *hash, const void *clave, size_t largo, void *dato_inicial){
+    bool insertada;
+    campo_t* campo = hash_buscar_o_insertar(hash, clave, largo, funcion_hash(hash, clave, largo),
+                                             dato_inicial, &insertada);
+    if (campo && !insertada) hash_contar_consulta(hash, true);
+    return campo ? &campo->valor : NULL;
+}
 
-    campo = campo_crear(copia_clave,dato);
+bool hash_actualizar(hash_t *hash, const char *clave,
+                     void *actualizar(void *dato, bool existia, void *extra), void *extra){
+    return hash_actualizar_n(hash, clave, strlen(clave), actualizar, extra);
+}
 
-    if (campo == NULL){
-       free(copia_clave);
-       return false;
-    }
+bool hash_actualizar_n(hash_t *hash, const void *clave, size_t largo,
+                       void *actualizar(void *dato, bool existia, void *extra), void *extra){
+    bool insertada;
+    campo_t* campo = hash_buscar_o_insertar(hash, clave, largo, funcion_hash(hash, clave, largo),
+                                             NULL, &insertada);
+    if (campo == NULL) return false;
 
-    lista_t** baldes = hash->baldes;
+    campo->valor = actualizar(campo->valor, !insertada, extra);
+    CONTAR(&hash->contadores, reemplazos, !insertada);
+    return true;
+}
 
-    if (baldes[num_hash] == NULL){
-        baldes[num_hash] = lista_crear();
-    }
+bool hash_reservar(hash_t *hash, size_t cantidad){
+    if (cantidad < hash_cantidad(hash)) cantidad = hash_cantidad(hash);
+    if (!hash_terminar_migracion(hash)) return false;
 
-    if ((baldes[num_hash] == NULL) || (!lista_insertar_ultimo(baldes[num_hash],campo)) ){
-        campo_destruir(campo);
-        return false;
-    }
-    hash->cantidad++;
+    tabla_t* actual = &hash->actual;
+    if (!hash_excede_carga(hash, cantidad + actual->borrados, actual->capacidad)) return true;
+
+    // Si sólo sobran borrados se reacomoda a la misma capacidad: reservar nunca achica.
+    size_t capacidad = capacidad_para(hash, cantidad);
+    if (capacidad == 0) return false;
+    if (capacidad < actual->capacidad) capacidad = actual->capacidad;
+    if (capacidad < hash->capacidad_minima) capacidad = hash->capacidad_minima;
+    if (!hash_redimensionar_a(hash, capacidad)) return false;
+    hash_migrar(hash, SIZE_MAX);
+    return true;
+}
+
+bool hash_compactar(hash_t *hash){
+    if (!hash_terminar_migracion(hash)) return false;
+
+    tabla_t* actual = &hash->actual;
+    size_t capacidad = capacidad_para(hash, actual->cantidad);
+    if (capacidad < hash->capacidad_minima) capacidad = hash->capacidad_minima;
+    if (capacidad == actual->capacidad && actual->borrados == 0) return true;
+
+    if (!hash_redimensionar_a(hash, capacidad)) return false;
+    hash_migrar(hash, SIZE_MAX);
     return true;
 }
 
+bool hash_guardar_lote(hash_t *hash, const char *const *claves, void *const *datos,
+                       size_t cantidad, bool claves_unicas){
+    return _hash_guardar_lote(hash, (const void *const *)claves, NULL, datos, cantidad, claves_unicas);
+}
+
+bool hash_guardar_lote_n(hash_t *hash, const void *const *claves, const size_t *largos,
+                         void *const *datos, size_t cantidad, bool claves_unicas){
+    return _hash_guardar_lote(hash, claves, largos, datos, cantidad, claves_unicas);
+}
+
 void *hash_borrar(hash_t *hash, const char *clave){
+    if (!clave) return NULL;
+    return hash_borrar_n(hash, clave, strlen(clave));
+}
+
+void *hash_borrar_n(hash_t *hash, const void *clave, size_t largo){
     if (hash_cantidad(hash) == 0 || !clave){
         return NULL;
     }
+    return hash_borrar_con_hash(hash, clave, largo, funcion_hash(hash, clave, largo));
+}
 
-    if ( (hash->capacidad > CAPACIDAD_INICIAL) && (hash->cantidad/hash->capacidad <= 1/CRITERIO_REDUCCION)) {
-        if (!hash_redimensionar_capacidad(hash,reducir_capacidad)) return NULL;
+void *hash_borrar_con_hash(hash_t *hash, const void *clave, size_t largo, uint64_t num_hash){
+    if (hash_cantidad(hash) == 0 || !clave){
+        return NULL;
     }
 
-    size_t largo_hash = hash->capacidad;
-    size_t indice_balde = funcion_hash(clave, largo_hash);
-    campo_t* campo = _hash_obtener(hash, clave, indice_balde, BORRAR_NODO);
-    
-    if (campo == NULL) return NULL;
+    hash_migrar(hash, POSICIONES_POR_MIGRACION);
+
+    size_t posicion;
+    tabla_t* tabla = _hash_obtener(hash, clave, largo, (size_t)num_hash, &posicion);
 
-    hash->cantidad--;
+    if (tabla == NULL) return NULL;
+
+    campo_t* campo = &tabla->campos[posicion];
     void* valor = campo->valor;
-    campo_destruir(campo);
+    hash_liberar_clave(hash, campo);
+    tabla_liberar(tabla, posicion);
+    CONTAR(&hash->contadores, eliminaciones, 1);
+
+    if (tabla == &hash->anterior && tabla->cantidad == 0){
+        tabla_destruir(tabla);
+        hash->migradas = 0;
+    }
+
+    /* Se evalúa con el elemento ya borrado; si no hay memoria para la tabla
+    más chica, el hash simplemente sigue con la capacidad que tenía. */
+    if (hash_debe_reducirse(hash) && hash_redimensionar_capacidad(hash,reducir_capacidad)){
+        hash_migrar(hash, POSICIONES_POR_MIGRACION);
+    }
     return valor;
 }
 
 void *hash_obtener(const hash_t *hash, const char *clave){
+    if (!clave) return NULL;
+    return hash_obtener_n(hash, clave, strlen(clave));
+}
+
+void *hash_obtener_n(const hash_t *hash, const void *clave, size_t largo){
+    if (hash_cantidad(hash) == 0 || !clave){
+        hash_contar_consulta(hash, false);
+        return NULL;
+    }
+    return hash_obtener_con_hash(hash, clave, largo, funcion_hash(hash, clave, largo));
+}
+
+void *hash_obtener_con_hash(const hash_t *hash, const void *clave, size_t largo, uint64_t num_hash){
     if (hash_cantidad(hash) == 0 || !clave){
+        hash_contar_consulta(hash, false);
         return NULL;
     }
 
-    size_t indice_balde = funcion_hash(clave,hash->capacidad);
-    campo_t* campo = _hash_obtener(hash, clave,indice_balde, !BORRAR_NODO);
-    return campo ? campo->valor : NULL;
+    size_t posicion;
+    tabla_t* tabla = _hash_obtener(hash, clave, largo, (size_t)num_hash, &posicion);
+    hash_contar_consulta(hash, tabla != NULL);
+    return tabla ? tabla->campos[posicion].valor : NULL;
+}
+
+/* Busca un lote de claves en tres pasadas: primero calcula todos los hashes y pide
+precargar los bytes de control de sus primeros grupos; luego, con esos bytes ya
+en caché, pide precargar el campo candidato de cada clave; y recién después
+resuelve cada búsqueda. Así los fallos de caché de las distintas claves se
+esperan a la vez y no uno detrás de otro.
+Si largos es NULL las claves son cadenas terminadas en '\0'. */
+void _hash_obtener_lote(const hash_t *hash, const void *const *claves, const size_t *largos,
+                        size_t cantidad, void **datos){
+    size_t num_hash[TAM_LOTE];
+    size_t largo[TAM_LOTE];
+
+    for (size_t inicio = 0; inicio < cantidad; inicio += TAM_LOTE){
+        size_t fin = cantidad - inicio < TAM_LOTE ? cantidad - inicio : TAM_LOTE;
+
+        for (size_t i = 0; i < fin; i++){
+            const void* clave = claves[inicio + i];
+            if (!clave) continue;
+            largo[i] = largos ? largos[inicio + i] : strlen(clave);
+            num_hash[i] = funcion_hash(hash, clave, largo[i]);
+            tabla_precargar_control(&hash->actual, num_hash[i]);
+            if (hash_migrando(hash)) tabla_precargar_control(&hash->anterior, num_hash[i]);
+        }
+
+        for (size_t i = 0; i < fin; i++){
+            if (!claves[inicio + i]) continue;
+            tabla_precargar_campo(&hash->actual, num_hash[i]);
+            if (hash_migrando(hash)) tabla_precargar_campo(&hash->anterior, num_hash[i]);
+        }
+
+        for (size_t i = 0; i < fin; i++){
+            const void* clave = claves[inicio + i];
+            size_t posicion;
+            tabla_t* tabla = clave ? _hash_obtener(hash, clave, largo[i], num_hash[i], &posicion) : NULL;
+            datos[inicio + i] = tabla ? tabla->campos[posicion].valor : NULL;
+            hash_contar_consulta(hash, tabla != NULL);
+        }
+    }
+}
+
+void hash_obtener_lote(const hash_t *hash, const char *const *claves, size_t cantidad, void **datos){
+    _hash_obtener_lote(hash, (const void *const *)claves, NULL, cantidad, datos);
+}
+
+void hash_obtener_lote_n(const hash_t *hash, const void *const *claves, const size_t *largos,
+                         size_t cantidad, void **datos){
+    _hash_obtener_lote(hash, claves, largos, cantidad, datos);
 }
 
 bool hash_pertenece(const hash_t *hash, const char *clave){
-    if (hash_cantidad(hash) == 0 || !clave) return NULL;
+    if (!clave) return false;
+    return hash_pertenece_n(hash, clave, strlen(clave));
+}
 
-    size_t num_hash = funcion_hash(clave,hash->capacidad);
-    campo_t* campo = _hash_obtener(hash, clave, num_hash, !BORRAR_NODO);
-    return campo != NULL;
+bool hash_pertenece_n(const hash_t *hash, const void *clave, size_t largo){
+    if (hash_cantidad(hash) == 0 || !clave){
+        hash_contar_consulta(hash, false);
+        return false;
+    }
+    return hash_pertenece_con_hash(hash, clave, largo, funcion_hash(hash, clave, largo));
+}
+
+bool hash_pertenece_con_hash(const hash_t *hash, const void *clave, size_t largo, uint64_t num_hash){
+    if (hash_cantidad(hash) == 0 || !clave){
+        hash_contar_consulta(hash, false);
+        return false;
+    }
+
+    size_t posicion;
+    bool pertenece = _hash_obtener(hash, clave, largo, (size_t)num_hash, &posicion) != NULL;
+    hash_contar_consulta(hash, pertenece);
+    return pertenece;
 }
 
 size_t hash_cantidad(const hash_t *hash){
-    return hash->cantidad;
+    return hash->actual.cantidad + hash->anterior.cantidad;
+}
+
+void hash_liberar_dato(const hash_t *hash, void *dato){
+    if (hash->destruir_dato) hash->destruir_dato(dato);
+}
+
+void hash_estadisticas(const hash_t *hash, hash_estadisticas_t *estadisticas){
+    *estadisticas = (hash_estadisticas_t){0};
+    const tabla_t* tablas[] = {&hash->actual, &hash->anterior};
+    size_t suma_sondeos = 0;
+
+    for (size_t t = 0; t < 2; t++){
+        const tabla_t* tabla = tablas[t];
+        estadisticas->capacidad += tabla->capacidad;
+        estadisticas->borrados += tabla->borrados;
+        estadisticas->bytes_control += tabla->capacidad * sizeof(int8_t);
+        estadisticas->bytes_campos += tabla->capacidad * sizeof(campo_t);
+
+        for (size_t i = 0; i < tabla->capacidad; i++){
+            if (tabla->control[i] < 0) continue;
+
+            const campo_t* campo = &tabla->campos[i];
+            if (campo->largo >= LARGO_CLAVE_INTERNA) estadisticas->bytes_claves += campo->largo + 1;
+
+            size_t sondeo = tabla_largo_sondeo(tabla, i);
+            suma_sondeos += sondeo;
+            if (sondeo > estadisticas->sondeo_maximo) estadisticas->sondeo_maximo = sondeo;
+            if (sondeo > HASH_LARGO_HISTOGRAMA) sondeo = HASH_LARGO_HISTOGRAMA;
+            estadisticas->histograma_sondeo[sondeo - 1]++;
+        }
+    }
+
+    /* Con arena, las claves ocupan lo que la arena le pidió a malloc */
+    if (hash->arena) estadisticas->bytes_claves = arena_memoria(hash->arena);
+
+    estadisticas->cantidad = hash_cantidad(hash);
+    estadisticas->factor_carga = (double)(estadisticas->cantidad + estadisticas->borrados) / (double)estadisticas->capacidad;
+    estadisticas->sondeo_promedio = estadisticas->cantidad ? (double)suma_sondeos / (double)estadisticas->cantidad : 0;
+    estadisticas->redimensiones = hash->redimensiones;
+    estadisticas->migrando = hash_migrando(hash);
+    estadisticas->bytes_totales = sizeof(hash_t) + estadisticas->bytes_control +
+                                  estadisticas->bytes_campos + estadisticas->bytes_claves;
+}
+
+bool hash_contadores(const hash_t *hash, hash_contadores_t *contadores){
+    const hash_contadores_t* propios = &hash->contadores;
+    contadores->consultas = __atomic_load_n(&propios->consultas, __ATOMIC_RELAXED);
+    contadores->aciertos = __atomic_load_n(&propios->aciertos, __ATOMIC_RELAXED);
+    contadores->fallos = __atomic_load_n(&propios->fallos, __ATOMIC_RELAXED);
+    contadores->inserciones = __atomic_load_n(&propios->inserciones, __ATOMIC_RELAXED);
+    contadores->reemplazos = __atomic_load_n(&propios->reemplazos, __ATOMIC_RELAXED);
+    contadores->eliminaciones = __atomic_load_n(&propios->eliminaciones, __ATOMIC_RELAXED);
+    contadores->grupos_sondeados = __atomic_load_n(&propios->grupos_sondeados, __ATOMIC_RELAXED);
+    contadores->comparaciones = __atomic_load_n(&propios->comparaciones, __ATOMIC_RELAXED);
+    contadores->nanosegundos_redimension = __atomic_load_n(&propios->nanosegundos_redimension, __ATOMIC_RELAXED);
+#ifdef HASH_CONTADORES
+    return true;
+#else
+    return false;
+#endif
+}
+
+void hash_contadores_reiniciar(hash_t *hash){
+    hash_contadores_t* propios = &hash->contadores;
+    __atomic_store_n(&propios->consultas, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&propios->aciertos, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&propios->fallos, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&propios->inserciones, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&propios->reemplazos, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&propios->eliminaciones, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&propios->grupos_sondeados, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&propios->comparaciones, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&propios->nanosegundos_redimension, 0, __ATOMIC_RELAXED);
 }
 
 void hash_destruir(hash_t *hash){
     hash_destruir_dato_t destruir_dato = hash->destruir_dato;
+    tabla_t* tablas[] = {&hash->actual, &hash->anterior};
 
-    for (int i = 0; i < hash->capacidad ; i++){
-        lista_t* balde = hash->baldes[i];
+    /* Con arena, si no hay datos que destruir no hace falta recorrer los campos:
+    las claves se liberan todas juntas con la arena. */
+    bool recorrer = destruir_dato != NULL || hash->arena == NULL;
 
-        if (balde == NULL) continue;
+    for (size_t t = 0; t < 2; t++){
+        tabla_t* tabla = tablas[t];
 
-        while (!lista_esta_vacia(balde)){
-            campo_t* campo = lista_borrar_primero(balde);
+        for (size_t i = 0; recorrer && i < tabla->capacidad ; i++){
+            if (tabla->control[i] < 0) continue;
+
+            campo_t* campo = &tabla->campos[i];
             if (destruir_dato != NULL) destruir_dato(campo->valor);
-            campo_destruir(campo);
+            if (hash->arena == NULL) hash_liberar_clave(hash, campo);
         }
-        lista_destruir(balde,NULL);
+        tabla_destruir(tabla);
     }
 
-    free(hash->baldes);
+    if (hash->arena != NULL) arena_destruir(hash->arena);
     free(hash);
 }
 
 /***************************
-* Primitivas del Iterador
+* Primitivas del Iterador Interno
 ****************************/
 
-hash_iter_t *hash_iter_crear(const hash_t *hash){
-    lista_t** arreglo_hash = hash->baldes;
-    if (!arreglo_hash){
-        return NULL;
+void hash_iterar(hash_t *hash, bool visitar(const char *clave, void *dato, void *extra), void *extra){
+    tabla_t* tablas[] = {&hash->actual, &hash->anterior};
+
+    for (size_t t = 0; t < 2; t++){
+        tabla_t* tabla = tablas[t];
+
+        for (size_t i = 0; i < tabla->capacidad; i++){
+            if (tabla->control[i] < 0) continue;
+
+            campo_t* campo = &tabla->campos[i];
+            if (!visitar(campo_clave(campo), campo->valor, extra)) return;
+        }
     }
+}
+
+/***************************
+* Primitivas del Iterador Externo
+****************************/
+
+hash_iter_t *hash_iter_crear(const hash_t *hash){
     hash_iter_t *iterador_hash = malloc(sizeof(hash_iter_t));
     if (!iterador_hash){
         return NULL;
     }
-    iterador_hash->hash = hash;
-    iterador_hash->balde_actual = 0;
-    iterador_hash->iterados = 0;
-    iterador_hash->balde_iter = hash_iter_crear_balde_iter(iterador_hash);
+    hash_iter_iniciar(iterador_hash, hash);
 
     return iterador_hash;
 }
 
+void hash_iter_iniciar(hash_iter_t *iter, const hash_t *hash){
+    iter->hash = hash;
+    iter->tabla = ITER_TABLA_ACTUAL;
+    iter->posicion = 0;
+    hash_iter_acomodar(iter);
+}
+
 bool hash_iter_avanzar(hash_iter_t *iter){
     if (hash_iter_al_final(iter)) return false;
 
-    lista_iter_t* balde_iter = iter->balde_iter;
+    iter->posicion++;
+    hash_iter_acomodar(iter);
+    return true;
+}
 
-    lista_iter_avanzar(balde_iter);
-    iter->iterados++;
-    
-    if (!lista_iter_al_final(balde_iter) || hash_iter_al_final(iter)) return true;
+const char *hash_iter_ver_actual(const hash_iter_t *iter){
+    if (hash_iter_al_final(iter)) return NULL;
 
-    iter->balde_actual++;
+    return campo_clave(&hash_iter_tabla(iter)->campos[iter->posicion]);
+}
 
-    lista_iter_t* nuevo_balde_iter = hash_iter_crear_balde_iter(iter);
+const void *hash_iter_ver_actual_n(const hash_iter_t *iter, size_t *largo){
+    if (hash_iter_al_final(iter)) return NULL;
 
-    if (nuevo_balde_iter == NULL) return false; //falso negativo;
+    const campo_t* campo = &hash_iter_tabla(iter)->campos[iter->posicion];
+    if (largo) *largo = campo->largo;
+    return campo_clave(campo);
+}
 
-    iter->balde_iter = nuevo_balde_iter;
-    lista_iter_destruir(balde_iter);
+void *hash_iter_ver_valor(const hash_iter_t *iter){
+    if (hash_iter_al_final(iter)) return NULL;
 
-    return true;
+    return hash_iter_tabla(iter)->campos[iter->posicion].valor;
 }
 
-const char *hash_iter_ver_actual(const hash_iter_t *iter){
-    if (hash_iter_al_final(iter)) return NULL;
+bool hash_iter_reemplazar_valor(hash_iter_t *iter, void *dato){
+    if (hash_iter_al_final(iter)) return false;
 
-    campo_t* campo = lista_iter_ver_actual(iter->balde_iter);
-    return campo->clave;
+    campo_t* campo = &hash_iter_tabla(iter)->campos[iter->posicion];
+    if (iter->hash->destruir_dato) iter->hash->destruir_dato(campo->valor);
+    campo->valor = dato;
+    return true;
 }
 
 bool hash_iter_al_final(const hash_iter_t *iter){
-    return iter->iterados == hash_cantidad(iter->hash);
+    return iter->posicion >= hash_iter_tabla(iter)->capacidad;
 }
 
 void hash_iter_destruir(hash_iter_t* iter){
-    if (iter->balde_iter) lista_iter_destruir(iter->balde_iter);
     free(iter);
 }
+
+/***************************
+* Funciones auxiliares de la Imagen
+****************************/
+
+/* Una imagen es un archivo con el encabezado, los bytes de control y las entradas
+de una tabla armada igual que las del hash, seguidos por las claves y los datos.
+Las claves y los datos se referencian por su desplazamiento desde el comienzo
+del archivo, de modo que la imagen sirve en cualquier dirección de memoria en la
+que se la mapee. Los números se guardan en el orden de bytes de la máquina. */
+
+/* Definición del encabezado de una imagen. Los bytes de control le siguen
+inmediatamente, y las entradas a continuación de ellos. */
+typedef struct imagen_encabezado {
+    char magia[8];
+    uint64_t capacidad;
+    uint64_t cantidad;
+    uint64_t semilla;
+    uint64_t funcion;       // IMAGEN_FUNCION_*
+    uint64_t tam;           // tamaño de toda la imagen
+} imagen_encabezado_t;
+
+/* Definición de una entrada de la imagen: el equivalente a un campo. */
+typedef struct imagen_entrada {
+    uint64_t num_hash;
+    uint64_t clave;         // desplazamiento de la clave, seguida de un '\0'
+    uint64_t largo_clave;
+    uint64_t dato;          // desplazamiento del dato
+    uint64_t largo_dato;
+} imagen_entrada_t;
+
+/* Definición del struct hash_mapeado */
+struct hash_mapeado {
+    const unsigned char* imagen;
+    size_t tam;
+    const int8_t* control;
+    const imagen_entrada_t* entradas;
+    size_t capacidad;
+    size_t cantidad;
+    hash_funcion_t funcion;
+    uint64_t semilla;
+};
+
+/* Redondea el desplazamiento hacia arriba a un múltiplo de IMAGEN_ALINEACION. */
+static inline uint64_t imagen_alinear(uint64_t desplazamiento){
+    return (desplazamiento + IMAGEN_ALINEACION - 1) & ~(uint64_t)(IMAGEN_ALINEACION - 1);
+}
+
+/* Escribe en el archivo los bytes recibidos seguidos de ceros hasta completar
+un múltiplo de IMAGEN_ALINEACION. Devuelve el desplazamiento siguiente. */
+uint64_t imagen_escribir(FILE* archivo, uint64_t desplazamiento, const void* bytes, size_t largo, bool* ok){
+    static const char ceros[IMAGEN_ALINEACION];
+    uint64_t siguiente = imagen_alinear(desplazamiento + largo);
+
+    if (largo > 0 && fwrite(bytes, 1, largo, archivo) != largo) *ok = false;
+    size_t relleno = (size_t)(siguiente - desplazamiento - largo);
+    if (relleno > 0 && fwrite(ceros, 1, relleno, archivo) != relleno) *ok = false;
+    return siguiente;
+}
+
+/* Devuelve el código de la función de hashing del hash para guardar en la imagen. */
+uint64_t imagen_codigo_funcion(const hash_t* hash){
+    if (hash->funcion == hash_funcion_defecto) return IMAGEN_FUNCION_DEFECTO;
+    if (hash->funcion == hash_funcion_djb2) return IMAGEN_FUNCION_DJB2;
+    return IMAGEN_FUNCION_PROPIA;
+}
+
+/* Verifica que la imagen mapeada tenga un encabezado coherente con su tamaño. */
+bool imagen_validar(const imagen_encabezado_t* encabezado, size_t tam){
+    if (tam < sizeof(imagen_encabezado_t)) return false;
+    if (memcmp(encabezado->magia, IMAGEN_MAGIA, sizeof(encabezado->magia)) != 0) return false;
+    if (encabezado->tam != tam || encabezado->funcion > IMAGEN_FUNCION_PROPIA) return false;
+
+    uint64_t capacidad = encabezado->capacidad;
+    if (capacidad < TAM_GRUPO || (capacidad & (capacidad - 1)) != 0) return false;
+    if (capacidad > (tam - sizeof(imagen_encabezado_t)) / (1 + sizeof(imagen_entrada_t))) return false;
+    return encabezado->cantidad < capacidad;
+}
+
+/***************************
+* Primitivas de la Imagen
+****************************/
+
+bool hash_serializar(const hash_t *hash, const char *ruta, hash_dato_a_bytes_t dato_a_bytes){
+    size_t capacidad = capacidad_para(hash, hash_cantidad(hash));
+    int8_t* control = malloc(capacidad);
+    imagen_entrada_t* entradas = calloc(capacidad, sizeof(imagen_entrada_t));
+    FILE* archivo = fopen(ruta, "wb");
+    if (!control || !entradas || !archivo){
+        free(control);
+        free(entradas);
+        if (archivo){
+            fclose(archivo);
+            remove(ruta);
+        }
+        return false;
+    }
+    memset(control, VACIO, capacidad);
+
+    /* Las claves y los datos se escriben a medida que se ubica cada campo en la
+    tabla de la imagen; el encabezado, los bytes de control y las entradas, que
+    van antes, se escriben al final, cuando ya están completos. */
+    tabla_t imagen = {control, NULL, capacidad, 0, 0, NULL};
+    uint64_t inicio_datos = sizeof(imagen_encabezado_t) + capacidad + capacidad * sizeof(imagen_entrada_t);
+    uint64_t desplazamiento = inicio_datos;
+    bool ok = fseek(archivo, (long)inicio_datos, SEEK_SET) == 0;
+
+    const tabla_t* tablas[] = {&hash->actual, &hash->anterior};
+    for (size_t t = 0; t < 2 && ok; t++){
+        const tabla_t* tabla = tablas[t];
+
+        for (size_t i = 0; i < tabla->capacidad && ok; i++){
+            if (tabla->control[i] < 0) continue;
+
+            const campo_t* campo = &tabla->campos[i];
+            size_t posicion = tabla_buscar_libre(&imagen, campo->num_hash);
+            control[posicion] = (int8_t)(campo->num_hash & H2_MASCARA);
+
+            imagen_entrada_t* entrada = &entradas[posicion];
+            entrada->num_hash = campo->num_hash;
+            entrada->clave = desplazamiento;
+            entrada->largo_clave = campo->largo;
+            desplazamiento = imagen_escribir(archivo, desplazamiento, campo_clave(campo), campo->largo + 1, &ok);
+
+            /* Sin dato_a_bytes se guarda el valor del puntero */
+            const void* bytes = &campo->valor;
+            size_t largo = sizeof(campo->valor);
+            if (dato_a_bytes) largo = dato_a_bytes(campo->valor, &bytes);
+            if (bytes == NULL) largo = 0;
+            entrada->dato = desplazamiento;
+            entrada->largo_dato = largo;
+            desplazamiento = imagen_escribir(archivo, desplazamiento, bytes, largo, &ok);
+        }
+    }
+
+    imagen_encabezado_t encabezado = {
+        .capacidad = capacidad,
+        .cantidad = hash_cantidad(hash),
+        .semilla = hash->semilla,
+        .funcion = imagen_codigo_funcion(hash),
+        .tam = desplazamiento,
+    };
+    memcpy(encabezado.magia, IMAGEN_MAGIA, sizeof(encabezado.magia));
+
+    ok = ok && fseek(archivo, 0, SEEK_SET) == 0 &&
+         fwrite(&encabezado, sizeof(encabezado), 1, archivo) == 1 &&
+         fwrite(control, 1, capacidad, archivo) == capacidad &&
+         fwrite(entradas, sizeof(imagen_entrada_t), capacidad, archivo) == capacidad;
+    ok = fclose(archivo) == 0 && ok;
+
+    free(control);
+    free(entradas);
+    if (!ok) remove(ruta);
+    return ok;
+}
+
+hash_mapeado_t *hash_mapear(const char *ruta, hash_funcion_t funcion){
+    int descriptor = open(ruta, O_RDONLY);
+    if (descriptor < 0) return NULL;
+
+    struct stat estado;
+    if (fstat(descriptor, &estado) != 0 || estado.st_size < (off_t)sizeof(imagen_encabezado_t)){
+        close(descriptor);
+        return NULL;
+    }
+    size_t tam = (size_t)estado.st_size;
+    void* imagen = mmap(NULL, tam, PROT_READ, MAP_SHARED, descriptor, 0);
+    close(descriptor);          // el mapeo sigue siendo válido sin el descriptor
+    if (imagen == MAP_FAILED) return NULL;
+
+    const imagen_encabezado_t* encabezado = imagen;
+    hash_mapeado_t* mapa = malloc(sizeof(hash_mapeado_t));
+    if (!mapa || !imagen_validar(encabezado, tam) ||
+        (encabezado->funcion == IMAGEN_FUNCION_PROPIA && funcion == NULL)){
+        free(mapa);
+        munmap(imagen, tam);
+        return NULL;
+    }
+
+    mapa->imagen = imagen;
+    mapa->tam = tam;
+    mapa->capacidad = (size_t)encabezado->capacidad;
+    mapa->cantidad = (size_t)encabezado->cantidad;
+    mapa->control = (const int8_t*)(mapa->imagen + sizeof(imagen_encabezado_t));
+    mapa->entradas = (const imagen_entrada_t*)(mapa->imagen + sizeof(imagen_encabezado_t) + mapa->capacidad);
+    mapa->semilla = encabezado->semilla;
+    mapa->funcion = encabezado->funcion == IMAGEN_FUNCION_DEFECTO ? hash_funcion_defecto :
+                    encabezado->funcion == IMAGEN_FUNCION_DJB2 ? hash_funcion_djb2 : funcion;
+    return mapa;
+}
+
+const void *hash_mapeado_obtener(const hash_mapeado_t *mapa, const char *clave, size_t *largo_dato){
+    if (!clave) return NULL;
+    return hash_mapeado_obtener_n(mapa, clave, strlen(clave), largo_dato);
+}
+
+const void *hash_mapeado_obtener_n(const hash_mapeado_t *mapa, const void *clave, size_t largo,
+                                   size_t *largo_dato){
+    if (!clave) return NULL;
+
+    size_t num_hash = (size_t)mapa->funcion(clave, largo, mapa->semilla);
+    size_t mascara = mapa->capacidad / TAM_GRUPO - 1;
+    size_t grupo = (num_hash >> 7) & mascara;
+    int8_t h2 = (int8_t)(num_hash & H2_MASCARA);
+
+    for (size_t salto = 1; salto <= mascara + 1; salto++){
+        const int8_t* control = mapa->control + grupo * TAM_GRUPO;
+        uint32_t coincidencias = grupo_coincidencias(control, h2);
+
+        while (coincidencias){
+            const imagen_entrada_t* entrada = &mapa->entradas[grupo * TAM_GRUPO + (size_t)__builtin_ctz(coincidencias)];
+            coincidencias &= coincidencias - 1;
+            if (entrada->num_hash != num_hash || entrada->largo_clave != largo) continue;
+
+            /* Una imagen dañada no debe hacer leer fuera del mapeo */
+            if (entrada->clave > mapa->tam || largo > mapa->tam - entrada->clave ||
+                entrada->dato > mapa->tam || entrada->largo_dato > mapa->tam - entrada->dato) return NULL;
+
+            if (memcmp(mapa->imagen + entrada->clave, clave, largo) == 0){
+                if (largo_dato) *largo_dato = (size_t)entrada->largo_dato;
+                return mapa->imagen + entrada->dato;
+            }
+        }
+        if (grupo_vacios(control)) break;
+        grupo = (grupo + salto) & mascara;
+    }
+    return NULL;
+}
+
+bool hash_mapeado_pertenece(const hash_mapeado_t *mapa, const char *clave){
+    return hash_mapeado_obtener(mapa, clave, NULL) != NULL;
+}
+
+size_t hash_mapeado_cantidad(const hash_mapeado_t *mapa){
+    return mapa->cantidad;
+}
+
+void hash_mapeado_cerrar(hash_mapeado_t *mapa){
+    munmap((void*)mapa->imagen, mapa->tam);
+    free(mapa);
+}
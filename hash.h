@@ -3,21 +3,86 @@
 
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 
 // Los structs deben llamarse "hash" y "hash_iter".
 struct hash;
-struct hash_iter;
 
 typedef struct hash hash_t;
+
+// La definición del iterador es pública sólo para poder declararlo en el
+// stack (ver hash_iter_iniciar); sus campos no deben usarse directamente.
+struct hash_iter {
+    const hash_t *hash;
+    size_t tabla;
+    size_t posicion;
+};
+
 typedef struct hash_iter hash_iter_t;
 
 // tipo de función para destruir dato
 typedef void (*hash_destruir_dato_t)(void *);
 
-/* Crea el hash
+// tipo de función de hashing: recibe los bytes de la clave, su largo y una semilla
+typedef uint64_t (*hash_funcion_t)(const void *clave, size_t largo, uint64_t semilla);
+
+// parámetros de creación de un hash (ver hash_crear_con_config)
+typedef struct hash_config {
+    size_t capacidad_inicial;   // elementos que entran sin que el hash crezca
+    double factor_carga;        // proporción máxima de posiciones ocupadas, entre 0.0625 y 0.9375
+    size_t factor_crecimiento;  // por cuánto se multiplica la capacidad al crecer: 2, 4, 8, ..., 256
+    hash_funcion_t funcion;     // NULL para usar hash_funcion_defecto
+    uint64_t semilla;
+    bool usar_arena;            // copiar las claves largas en una arena (ver hash_crear_con_arena)
+} hash_config_t;
+
+/* Devuelve la configuración con la que hash_crear crea el hash: capacidad
+ * inicial mínima, factor de carga 7/8, factor de crecimiento 2, función de
+ * hashing por defecto, semilla aleatoria y sin arena. Se la puede modificar
+ * campo por campo antes de pasarla a hash_crear_con_config.
+ */
+hash_config_t hash_config_defecto(void);
+
+/* Crea el hash con la configuración recibida. Un factor de carga bajo hace
+ * las búsquedas más rápidas a cambio de más memoria, y uno alto al revés.
+ * El hash nunca se achica por debajo de su capacidad inicial. Devuelve NULL
+ * si la configuración no es válida o si no hay memoria.
+ */
+hash_t *hash_crear_con_config(hash_destruir_dato_t destruir_dato, const hash_config_t *config);
+
+/* Crea el hash. Usa la función de hashing por defecto con una semilla
+ * aleatoria, por lo que el orden de iteración cambia entre ejecuciones.
  */
 hash_t *hash_crear(hash_destruir_dato_t destruir_dato);
 
+/* Crea el hash usando la función de hashing y la semilla recibidas. Si
+ * funcion es NULL se usa hash_funcion_defecto.
+ */
+hash_t *hash_crear_con_funcion(hash_destruir_dato_t destruir_dato, hash_funcion_t funcion, uint64_t semilla);
+
+/* Crea el hash igual que hash_crear, pero las copias de las claves se
+ * cortan de losas grandes que pertenecen al hash. Insertar muchas claves
+ * hace pocos pedidos de memoria, y hash_destruir libera todas las claves
+ * juntas en lugar de una por una.
+ */
+hash_t *hash_crear_con_arena(hash_destruir_dato_t destruir_dato);
+
+/* Función de hashing por defecto (wyhash): procesa la clave de a 8 bytes
+ * y, con una semilla secreta, hace impráctico elegir claves que colisionen.
+ */
+uint64_t hash_funcion_defecto(const void *clave, size_t largo, uint64_t semilla);
+
+/* Función de hashing djb2, byte a byte, con los bits finales mezclados.
+ */
+uint64_t hash_funcion_djb2(const void *clave, size_t largo, uint64_t semilla);
+
+/* Devuelve una semilla aleatoria, sacada del generador del sistema operativo
+ * (getrandom o /dev/urandom), que no se puede predecir desde afuera del
+ * proceso. Si el sistema no la da, se la arma con el reloj y la ubicación de
+ * la memoria, que es más débil pero igual distinta en cada llamado.
+ */
+uint64_t hash_semilla_aleatoria(void);
+
 /* Guarda un elemento en el hash, si la clave ya se encuentra en la
  * estructura, la reemplaza. De no poder guardarlo devuelve false.
  * Pre: La estructura hash fue inicializada
@@ -25,6 +90,60 @@ hash_t *hash_crear(hash_destruir_dato_t destruir_dato);
  */
 bool hash_guardar(hash_t *hash, const char *clave, void *dato);
 
+/* Devuelve la dirección en la que el hash guarda el dato de la clave. Si la
+ * clave no estaba, antes la guarda con dato_inicial. La clave se busca una
+ * sola vez, por lo que leer y escribir *dato a través del puntero devuelto es
+ * más rápido que un hash_obtener seguido de un hash_guardar. La dirección deja
+ * de ser válida al modificar el hash (guardar, borrar, reservar, etc.).
+ * Devuelve NULL si no pudo guardar la clave.
+ * Pre: La estructura hash fue inicializada
+ * Post: La clave pertenece al hash.
+ */
+void **hash_obtener_o_insertar(hash_t *hash, const char *clave, void *dato_inicial);
+
+/* Reemplaza el dato de la clave por lo que devuelve actualizar, que recibe el
+ * dato actual (NULL si la clave no estaba), si la clave ya existía y el
+ * parámetro extra. La clave se busca una sola vez. A diferencia de
+ * hash_guardar, no se destruye el dato anterior: de eso se encarga actualizar
+ * si corresponde. Devuelve false si no pudo guardar la clave.
+ * Pre: La estructura hash fue inicializada. actualizar no modifica el hash.
+ * Post: La clave pertenece al hash con el dato devuelto por actualizar.
+ */
+bool hash_actualizar(hash_t *hash, const char *clave,
+                     void *actualizar(void *dato, bool existia, void *extra), void *extra);
+
+/* Reserva lugar para que el hash llegue a tener cantidad elementos sin
+ * tener que crecer. Devuelve false si no pudo pedir la memoria.
+ * Pre: La estructura hash fue inicializada
+ * Post: Se pueden guardar claves nuevas hasta llegar a cantidad elementos
+ * sin redimensionar el hash.
+ */
+bool hash_reservar(hash_t *hash, size_t cantidad);
+
+/* Lleva el hash a la menor capacidad en la que entran sus elementos (sin
+ * bajar de la capacidad inicial) y descarta las marcas de borrado, devolviendo
+ * en el momento la memoria que sobra (por ejemplo, después de borrar la
+ * mayoría de las claves). Al borrar, el hash ya se achica solo cuando le sobra
+ * mucho lugar; hash_compactar además lo deja lo más denso posible, por lo que
+ * las próximas inserciones pueden hacerlo crecer enseguida. Devuelve false si
+ * no pudo pedir la memoria, en cuyo caso el hash queda como estaba.
+ * Pre: La estructura hash fue inicializada
+ * Post: Los elementos del hash no cambiaron.
+ */
+bool hash_compactar(hash_t *hash);
+
+/* Guarda los pares (claves[i], datos[i]) para i entre 0 y cantidad - 1, igual
+ * que si se llamara a hash_guardar con cada uno, pero reservando lugar para
+ * todos de una vez. Si claves_unicas es true, no se busca cada clave antes de
+ * guardarla. Devuelve false si no pudo guardar todos los pares, en cuyo caso
+ * algunos pueden haber quedado guardados.
+ * Pre: La estructura hash fue inicializada. Si claves_unicas es true, las
+ * claves son distintas entre sí y ninguna está en el hash.
+ * Post: Se almacenaron los pares.
+ */
+bool hash_guardar_lote(hash_t *hash, const char *const *claves, void *const *datos,
+                       size_t cantidad, bool claves_unicas);
+
 /* Borra un elemento del hash y devuelve el dato asociado.  Devuelve
  * NULL si el dato no estaba.
  * Pre: La estructura hash fue inicializada
@@ -39,6 +158,15 @@ void *hash_borrar(hash_t *hash, const char *clave);
  */
 void *hash_obtener(const hash_t *hash, const char *clave);
 
+/* Obtiene los valores de cantidad claves a la vez y los deja en datos[0] a
+ * datos[cantidad - 1] (NULL para las claves que no se encuentran). Equivale a
+ * llamar a hash_obtener con cada clave, pero superpone los accesos a memoria
+ * de varias búsquedas, por lo que es más rápido para lotes grandes.
+ * Pre: La estructura hash fue inicializada. datos tiene lugar para cantidad
+ * punteros.
+ */
+void hash_obtener_lote(const hash_t *hash, const char *const *claves, size_t cantidad, void **datos);
+
 /* Determina si clave pertenece o no al hash.
  * Pre: La estructura hash fue inicializada
  */
@@ -49,6 +177,99 @@ bool hash_pertenece(const hash_t *hash, const char *clave);
  */
 size_t hash_cantidad(const hash_t *hash);
 
+/* Libera el dato con la función destruir_dato del hash, si tiene una. Sirve
+ * para descartar un dato armado para el hash que no se pudo guardar.
+ * Pre: La estructura hash fue inicializada
+ */
+void hash_liberar_dato(const hash_t *hash, void *dato);
+
+// posiciones del histograma de largos de sondeo de hash_estadisticas_t
+#define HASH_LARGO_HISTOGRAMA 16
+
+// estado de un hash en un momento dado (ver hash_estadisticas)
+typedef struct hash_estadisticas {
+    size_t cantidad;
+    size_t capacidad;           // posiciones de la tabla, más las de la anterior si está migrando
+    size_t borrados;            // posiciones con marca de borrado
+    double factor_carga;        // (cantidad + borrados) / capacidad
+    bool migrando;              // si hay una redimensión incremental en curso
+    size_t redimensiones;       // veces que cambió de tabla desde que se creó
+    size_t bytes_control;       // bytes de control, uno por posición
+    size_t bytes_campos;        // arreglo de campos (clave corta, valor y hash de cada posición)
+    size_t bytes_claves;        // copias de las claves largas (toda la arena, si se usa una)
+    size_t bytes_totales;       // todo lo anterior más la estructura del hash; no incluye los datos
+    size_t sondeo_maximo;       // grupos que recorre la búsqueda más larga de una clave guardada
+    double sondeo_promedio;     // grupos que recorre en promedio
+    // histograma_sondeo[i]: claves cuya búsqueda recorre i + 1 grupos; la
+    // última posición acumula también las que recorren más
+    size_t histograma_sondeo[HASH_LARGO_HISTOGRAMA];
+} hash_estadisticas_t;
+
+/* Llena estadisticas con la memoria que usa el hash y qué tan bien están
+ * repartidas sus claves. Un sondeo máximo o promedio alto indica que la
+ * función de hashing reparte mal las claves que se guardaron. Recorre todo
+ * el hash, por lo que no conviene llamarla en cada operación.
+ * Pre: La estructura hash fue inicializada
+ */
+void hash_estadisticas(const hash_t *hash, hash_estadisticas_t *estadisticas);
+
+// contadores de actividad de un hash (ver hash_contadores)
+typedef struct hash_contadores {
+    uint64_t consultas;         // hash_obtener, hash_pertenece y cada clave de un lote
+    uint64_t aciertos;          // consultas que encontraron la clave
+    uint64_t fallos;            // consultas que no la encontraron
+    uint64_t inserciones;       // claves nuevas guardadas
+    uint64_t reemplazos;        // datos reemplazados de claves que ya estaban
+    uint64_t eliminaciones;     // claves borradas
+    uint64_t grupos_sondeados;  // grupos de posiciones recorridos por todas las búsquedas
+    uint64_t comparaciones;     // claves comparadas por tener la misma huella
+    uint64_t nanosegundos_redimension;  // tiempo creando tablas y migrando campos
+} hash_contadores_t;
+
+/* Copia en contadores los contadores del hash desde que se creó (o desde el
+ * último hash_contadores_reiniciar). Los contadores sólo se llevan si la
+ * biblioteca se compiló con -DHASH_CONTADORES; si no, quedan en 0 y se
+ * devuelve false. Su costo es de unas pocas sumas por operación, sin
+ * instrucciones atómicas costosas, por lo que pueden quedar activados en
+ * producción. Si varios hilos consultan el mismo hash a la vez (por ejemplo,
+ * en hash_concurrente), algunas cuentas pueden perderse.
+ * Pre: La estructura hash fue inicializada
+ */
+bool hash_contadores(const hash_t *hash, hash_contadores_t *contadores);
+
+/* Vuelve a 0 todos los contadores del hash.
+ * Pre: La estructura hash fue inicializada
+ */
+void hash_contadores_reiniciar(hash_t *hash);
+
+/* Variantes de las primitivas anteriores para claves binarias: la clave son
+ * los largo bytes a partir de clave, que pueden incluir '\0' y no necesitan
+ * estar terminados en '\0'. Una clave guardada con hash_guardar es la misma
+ * que sus bytes sin el '\0' final guardados con hash_guardar_n.
+ * Pre: La estructura hash fue inicializada
+ */
+bool hash_guardar_n(hash_t *hash, const void *clave, size_t largo, void *dato);
+void *hash_borrar_n(hash_t *hash, const void *clave, size_t largo);
+void *hash_obtener_n(const hash_t *hash, const void *clave, size_t largo);
+bool hash_pertenece_n(const hash_t *hash, const void *clave, size_t largo);
+bool hash_guardar_lote_n(hash_t *hash, const void *const *claves, const size_t *largos,
+                         void *const *datos, size_t cantidad, bool claves_unicas);
+void hash_obtener_lote_n(const hash_t *hash, const void *const *claves, const size_t *largos,
+                         size_t cantidad, void **datos);
+void **hash_obtener_o_insertar_n(hash_t *hash, const void *clave, size_t largo, void *dato_inicial);
+bool hash_actualizar_n(hash_t *hash, const void *clave, size_t largo,
+                       void *actualizar(void *dato, bool existia, void *extra), void *extra);
+
+/* Variantes de las primitivas _n para quien ya calculó el hash de la clave, por
+ * ejemplo para repartir claves entre varios hashes, y no quiere recalcularlo.
+ * Pre: La estructura hash fue inicializada y num_hash es lo que devuelve la
+ * función de hashing del hash, con su semilla, para los largo bytes de clave.
+ */
+bool hash_guardar_con_hash(hash_t *hash, const void *clave, size_t largo, uint64_t num_hash, void *dato);
+void *hash_borrar_con_hash(hash_t *hash, const void *clave, size_t largo, uint64_t num_hash);
+void *hash_obtener_con_hash(const hash_t *hash, const void *clave, size_t largo, uint64_t num_hash);
+bool hash_pertenece_con_hash(const hash_t *hash, const void *clave, size_t largo, uint64_t num_hash);
+
 /* Destruye la estructura liberando la memoria pedida y llamando a la función
  * destruir para cada par (clave, dato).
  * Pre: La estructura hash fue inicializada
@@ -56,21 +277,91 @@ size_t hash_cantidad(const hash_t *hash);
  */
 void hash_destruir(hash_t *hash);
 
+/* Iterador interno del hash. Llama a visitar con cada par (clave, dato) y
+ * extra, hasta recorrer todo el hash o hasta que visitar devuelva false.
+ * No pide memoria.
+ * Pre: La estructura hash fue inicializada. visitar no modifica el hash.
+ */
+void hash_iterar(hash_t *hash, bool visitar(const char *clave, void *dato, void *extra), void *extra);
+
 /* Iterador del hash */
 
 // Crea iterador
 hash_iter_t *hash_iter_crear(const hash_t *hash);
 
+// Inicializa un iterador ya existente (por ejemplo, declarado en el stack)
+// para recorrer el hash. No pide memoria; el iterador no se destruye.
+void hash_iter_iniciar(hash_iter_t *iter, const hash_t *hash);
+
 // Avanza iterador
 bool hash_iter_avanzar(hash_iter_t *iter);
 
 // Devuelve clave actual, esa clave no se puede modificar ni liberar.
 const char *hash_iter_ver_actual(const hash_iter_t *iter);
 
+// Devuelve clave actual y guarda su largo en *largo (si largo no es NULL).
+// La clave siempre está seguida de un '\0' que no forma parte de ella.
+const void *hash_iter_ver_actual_n(const hash_iter_t *iter, size_t *largo);
+
+// Devuelve el dato asociado a la clave actual, o NULL si terminó la iteración.
+void *hash_iter_ver_valor(const hash_iter_t *iter);
+
+// Reemplaza el dato asociado a la clave actual, destruyendo el anterior con
+// la función destruir del hash, igual que hash_guardar. No invalida el
+// iterador. Devuelve false si terminó la iteración.
+bool hash_iter_reemplazar_valor(hash_iter_t *iter, void *dato);
+
 // Comprueba si terminó la iteración
 bool hash_iter_al_final(const hash_iter_t *iter);
 
-// Destruye iterador
+// Destruye iterador creado con hash_iter_crear
 void hash_iter_destruir(hash_iter_t* iter);
 
+/* Imagen del hash */
+
+// Hash de sólo lectura abierto desde una imagen (ver hash_mapear)
+typedef struct hash_mapeado hash_mapeado_t;
+
+// tipo de función que indica qué bytes guardar en una imagen para un dato:
+// deja en *bytes su dirección y devuelve cuántos son
+typedef size_t (*hash_dato_a_bytes_t)(const void *dato, const void **bytes);
+
+/* Escribe en el archivo de la ruta una imagen del hash: una tabla con la
+ * misma organización que la del hash, con las claves y los bytes de cada
+ * dato que devuelve dato_a_bytes. Si dato_a_bytes es NULL se guarda el valor
+ * de cada puntero (sirve cuando los datos son números guardados como
+ * punteros); si deja *bytes en NULL, el dato se guarda vacío. La imagen
+ * sólo puede abrirse en una máquina con el mismo orden de bytes. Devuelve
+ * false si no pudo escribir el archivo, en cuyo caso lo borra.
+ * Pre: La estructura hash fue inicializada
+ */
+bool hash_serializar(const hash_t *hash, const char *ruta, hash_dato_a_bytes_t dato_a_bytes);
+
+/* Abre una imagen escrita por hash_serializar mapeándola en memoria: no se
+ * lee el archivo ni se arma ninguna tabla, por lo que abrirla es inmediato
+ * y las páginas se cargan a medida que las búsquedas las necesitan. Si el
+ * hash usaba una función de hashing propia, hay que pasarla en funcion; si
+ * no, funcion se ignora. Devuelve NULL si el archivo no es una imagen válida.
+ */
+hash_mapeado_t *hash_mapear(const char *ruta, hash_funcion_t funcion);
+
+/* Devuelve la dirección de los bytes del dato de la clave dentro de la
+ * imagen, y guarda cuántos son en *largo_dato (si no es NULL). Devuelve NULL
+ * si la clave no está. Los bytes no pueden modificarse y dejan de ser
+ * válidos al cerrar el hash mapeado.
+ * Pre: El hash mapeado fue abierto
+ */
+const void *hash_mapeado_obtener(const hash_mapeado_t *mapa, const char *clave, size_t *largo_dato);
+const void *hash_mapeado_obtener_n(const hash_mapeado_t *mapa, const void *clave, size_t largo,
+                                   size_t *largo_dato);
+
+// Determina si la clave pertenece al hash mapeado
+bool hash_mapeado_pertenece(const hash_mapeado_t *mapa, const char *clave);
+
+// Devuelve la cantidad de elementos del hash mapeado
+size_t hash_mapeado_cantidad(const hash_mapeado_t *mapa);
+
+// Cierra el hash mapeado, liberando el mapeo de la imagen
+void hash_mapeado_cerrar(hash_mapeado_t *mapa);
+
 #endif // HASH_H
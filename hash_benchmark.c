@@ -0,0 +1,544 @@
+/*
+ * hash_benchmark.c
+ * Mediciones de rendimiento del hash, separadas de las pruebas de correctitud
+ *
+ * Uso: ./benchmark [maximo]           todas las cargas, con tablas de 10^3 a maximo elementos
+ *      ./benchmark concurrente [largo] hash concurrente contra un mutex global, de 1 a 8 hilos
+ */
+
+#define _POSIX_C_SOURCE 200809L  // clock_gettime
+#include "hash.h"
+#include "hash_concurrente.h"
+#include "hash_congelado.h"
+#include "hash_generico.h"
+
+#include <math.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define MAXIMO_DEFECTO 1000000
+#define LARGO_CONCURRENTE 1000000
+#define CONSULTAS 2000000           // consultas de cada medición de búsquedas y de la carga mixta
+#define CLAVES_LOTE 256
+#define EXPONENTE_ZIPF 0.99         // el de YCSB: unas pocas claves concentran casi todos los accesos
+#define PORCENTAJE_LECTURAS 80      // carga mixta: el resto se reparte entre guardar y borrar
+#define MAXIMO_HILOS 8
+#define PORCENTAJE_ESCRITURAS 10
+#define LARGO_CLAVE_CONCURRENTE 24
+
+static const size_t LARGOS_CLAVE[] = {8, 16, 32, 64};
+
+/* ******************************************************************
+ *                        FUNCIONES AUXILIARES
+ * *****************************************************************/
+
+// Evita que el compilador descarte las búsquedas cuyo resultado no se usa.
+static volatile size_t sumidero;
+
+static double segundos_actuales(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec + (double) ts.tv_nsec / 1e9;
+}
+
+/* Devuelve un número pseudoaleatorio (xorshift64). */
+static uint64_t aleatorio(uint64_t *estado)
+{
+    *estado ^= *estado << 13;
+    *estado ^= *estado >> 7;
+    *estado ^= *estado << 17;
+    return *estado;
+}
+
+/* Imprime una fila de resultados: nanosegundos por operación y millones de
+ * operaciones por segundo. */
+static void informar(const char *carga, const char *distribucion, size_t elementos,
+                     size_t largo_clave, size_t operaciones, double segundos)
+{
+    double ns = segundos * 1e9 / (double) operaciones;
+    printf("%-17s %-9s %10zu %6zu %10.1f %10.2f\n",
+           carga, distribucion, elementos, largo_clave, ns, 1e3 / ns);
+}
+
+/* ******************************************************************
+ *                        CLAVES Y DISTRIBUCIONES
+ * *****************************************************************/
+
+/* Claves de un mismo largo guardadas una detrás de otra. Las claves presentes
+ * son las 'cantidad' primeras; las ausentes, otras 'cantidad' que nunca se
+ * guardan. */
+typedef struct claves {
+    char *datos;
+    size_t largo;
+    size_t cantidad;
+} claves_t;
+
+static const char *clave(const claves_t *claves, size_t i)
+{
+    return claves->datos + i * (claves->largo + 1);
+}
+
+/* Genera 2 * cantidad claves distintas de exactamente 'largo' caracteres: el
+ * índice con ceros a la izquierda, completado con letras si sobra lugar. */
+static bool claves_crear(claves_t *claves, size_t cantidad, size_t largo)
+{
+    claves->datos = malloc(2 * cantidad * (largo + 1));
+    if (!claves->datos) return false;
+    claves->largo = largo;
+    claves->cantidad = cantidad;
+
+    char numero[32];
+    for (size_t i = 0; i < 2 * cantidad; i++) {
+        char *destino = claves->datos + i * (largo + 1);
+        int digitos = snprintf(numero, sizeof(numero), "%0*zu", (int) (largo < 20 ? largo : 20), i);
+        if ((size_t) digitos > largo) {         // no hay suficientes claves distintas de ese largo
+            free(claves->datos);
+            return false;
+        }
+        memset(destino, 'k', largo);
+        memcpy(destino + largo - (size_t) digitos, numero, (size_t) digitos);
+        destino[largo] = '\0';
+    }
+    return true;
+}
+
+/* Llena 'indices' con 'cantidad' índices en [0, n) según la distribución:
+ * uniforme, o Zipf con EXPONENTE_ZIPF. En la de Zipf el puesto de popularidad
+ * se asigna a las claves al azar, para que las más consultadas no sean las
+ * primeras que se guardaron. */
+static bool indices_generar(size_t *indices, size_t cantidad, size_t n, bool zipf, uint64_t semilla)
+{
+    uint64_t estado = semilla;
+    if (!zipf) {
+        for (size_t i = 0; i < cantidad; i++) indices[i] = (size_t) (aleatorio(&estado) % n);
+        return true;
+    }
+
+    double *acumulada = malloc(n * sizeof(double));
+    size_t *permutacion = malloc(n * sizeof(size_t));
+    if (!acumulada || !permutacion) {
+        free(acumulada);
+        free(permutacion);
+        return false;
+    }
+
+    double total = 0;
+    for (size_t i = 0; i < n; i++) {
+        total += 1.0 / pow((double) (i + 1), EXPONENTE_ZIPF);
+        acumulada[i] = total;
+        permutacion[i] = i;
+    }
+    for (size_t i = n - 1; i > 0; i--) {
+        size_t j = (size_t) (aleatorio(&estado) % (i + 1));
+        size_t auxiliar = permutacion[i];
+        permutacion[i] = permutacion[j];
+        permutacion[j] = auxiliar;
+    }
+
+    for (size_t i = 0; i < cantidad; i++) {
+        double u = (double) (aleatorio(&estado) >> 11) / 9007199254740992.0 * total;
+        size_t desde = 0, hasta = n - 1;
+        while (desde < hasta) {                 // primer puesto cuya acumulada supera u
+            size_t medio = desde + (hasta - desde) / 2;
+            if (acumulada[medio] < u) desde = medio + 1;
+            else hasta = medio;
+        }
+        indices[i] = permutacion[desde];
+    }
+
+    free(acumulada);
+    free(permutacion);
+    return true;
+}
+
+/* ******************************************************************
+ *                        CARGAS
+ * *****************************************************************/
+
+/* Crea un hash con las claves presentes. Los datos son el índice más uno, para
+ * poder distinguir un acierto de un fallo. */
+static hash_t *hash_llenar(const claves_t *claves)
+{
+    hash_t *hash = hash_crear(NULL);
+    for (size_t i = 0; hash && i < claves->cantidad; i++) {
+        if (!hash_guardar(hash, clave(claves, i), (void *) (uintptr_t) (i + 1))) {
+            hash_destruir(hash);
+            return NULL;
+        }
+    }
+    return hash;
+}
+
+static void medir_insertar(const claves_t *claves)
+{
+    double inicio = segundos_actuales();
+    hash_t *hash = hash_llenar(claves);
+    double segundos = segundos_actuales() - inicio;
+
+    if (!hash) {
+        fprintf(stderr, "insertar: no hay memoria para %zu elementos\n", claves->cantidad);
+        return;
+    }
+    informar("insertar", "-", claves->cantidad, claves->largo, claves->cantidad, segundos);
+    hash_destruir(hash);
+}
+
+/* Consulta las claves de los índices recibidos, sumando 'desplazamiento' a
+ * cada uno (cantidad para consultar las claves ausentes). */
+static void medir_obtener(const hash_t *hash, const claves_t *claves, const size_t *indices,
+                          size_t desplazamiento, const char *carga, const char *distribucion)
+{
+    size_t encontradas = 0;
+    double inicio = segundos_actuales();
+    for (size_t i = 0; i < CONSULTAS; i++) {
+        encontradas += hash_obtener(hash, clave(claves, indices[i] + desplazamiento)) != NULL;
+    }
+    double segundos = segundos_actuales() - inicio;
+    sumidero = encontradas;
+
+    if (encontradas != (desplazamiento ? 0 : CONSULTAS)) {
+        fprintf(stderr, "%s: se encontraron %zu claves de %d\n", carga, encontradas, CONSULTAS);
+    }
+    informar(carga, distribucion, claves->cantidad, claves->largo, CONSULTAS, segundos);
+}
+
+static void medir_obtener_lote(const hash_t *hash, const claves_t *claves, const size_t *indices,
+                               const char *distribucion)
+{
+    const char *lote[CLAVES_LOTE];
+    void *datos[CLAVES_LOTE];
+    size_t encontradas = 0;
+
+    double inicio = segundos_actuales();
+    for (size_t i = 0; i < CONSULTAS; i += CLAVES_LOTE) {
+        size_t cantidad = CONSULTAS - i < CLAVES_LOTE ? CONSULTAS - i : CLAVES_LOTE;
+        for (size_t j = 0; j < cantidad; j++) {
+            lote[j] = clave(claves, indices[i + j]);
+        }
+        hash_obtener_lote(hash, lote, cantidad, datos);
+        for (size_t j = 0; j < cantidad; j++) {
+            encontradas += datos[j] != NULL;
+        }
+    }
+    double segundos = segundos_actuales() - inicio;
+    sumidero = encontradas;
+
+    if (encontradas != CONSULTAS) {
+        fprintf(stderr, "acierto-lote: se encontraron %zu claves de %d\n", encontradas, CONSULTAS);
+    }
+    informar("acierto-lote", distribucion, claves->cantidad, claves->largo, CONSULTAS, segundos);
+}
+
+/* Mide cuánto tarda congelar el hash y las consultas al hash congelado, con
+ * claves presentes y ausentes. */
+static void medir_congelado(const hash_t *hash, const claves_t *claves, const size_t *indices)
+{
+    double inicio = segundos_actuales();
+    hash_congelado_t *congelado = hash_congelar(hash);
+    double segundos = segundos_actuales() - inicio;
+    if (!congelado) {
+        fprintf(stderr, "congelar: no hay memoria para %zu elementos\n", claves->cantidad);
+        return;
+    }
+    informar("congelar", "-", claves->cantidad, claves->largo, claves->cantidad, segundos);
+
+    for (size_t desplazamiento = 0; desplazamiento <= claves->cantidad; desplazamiento += claves->cantidad) {
+        const char *carga = desplazamiento ? "fallo-congelado" : "acierto-congelado";
+        size_t encontradas = 0;
+        inicio = segundos_actuales();
+        for (size_t i = 0; i < CONSULTAS; i++) {
+            encontradas += hash_congelado_obtener(congelado, clave(claves, indices[i] + desplazamiento)) != NULL;
+        }
+        segundos = segundos_actuales() - inicio;
+        sumidero = encontradas;
+
+        if (encontradas != (desplazamiento ? 0 : CONSULTAS)) {
+            fprintf(stderr, "%s: se encontraron %zu claves de %d\n", carga, encontradas, CONSULTAS);
+        }
+        informar(carga, "uniforme", claves->cantidad, claves->largo, CONSULTAS, segundos);
+    }
+    hash_congelado_destruir(congelado);
+}
+
+/* Mezcla PORCENTAJE_LECTURAS% de consultas con guardados y borrados en partes
+ * iguales, eligiendo las claves con la distribución de los índices. La cantidad
+ * de elementos se mantiene cerca de la inicial. */
+static void medir_mixta(const claves_t *claves, const size_t *indices, const char *distribucion)
+{
+    hash_t *hash = hash_llenar(claves);
+    if (!hash) return;
+
+    uint64_t estado = 0x9E3779B97F4A7C15u;
+    size_t encontradas = 0;
+    double inicio = segundos_actuales();
+    for (size_t i = 0; i < CONSULTAS; i++) {
+        const char *actual = clave(claves, indices[i]);
+        uint64_t tirada = aleatorio(&estado) % 100;
+
+        if (tirada < PORCENTAJE_LECTURAS) {
+            encontradas += hash_obtener(hash, actual) != NULL;
+        } else if (tirada % 2 == 0) {
+            hash_guardar(hash, actual, (void *) (uintptr_t) (indices[i] + 1));
+        } else {
+            encontradas += hash_borrar(hash, actual) != NULL;
+        }
+    }
+    double segundos = segundos_actuales() - inicio;
+    sumidero = encontradas;
+
+    informar("mixta", distribucion, claves->cantidad, claves->largo, CONSULTAS, segundos);
+    hash_destruir(hash);
+}
+
+/* Borra todas las claves en orden aleatorio. */
+static void medir_borrar(const claves_t *claves)
+{
+    hash_t *hash = hash_llenar(claves);
+    size_t *orden = malloc(claves->cantidad * sizeof(size_t));
+    if (!hash || !orden) {
+        if (hash) hash_destruir(hash);
+        free(orden);
+        return;
+    }
+
+    uint64_t estado = 0x2545F4914F6CDD1Du;
+    for (size_t i = 0; i < claves->cantidad; i++) orden[i] = i;
+    for (size_t i = claves->cantidad - 1; i > 0; i--) {
+        size_t j = (size_t) (aleatorio(&estado) % (i + 1));
+        size_t auxiliar = orden[i];
+        orden[i] = orden[j];
+        orden[j] = auxiliar;
+    }
+
+    double inicio = segundos_actuales();
+    for (size_t i = 0; i < claves->cantidad; i++) {
+        hash_borrar(hash, clave(claves, orden[i]));
+    }
+    double segundos = segundos_actuales() - inicio;
+
+    informar("borrar", "-", claves->cantidad, claves->largo, claves->cantidad, segundos);
+    free(orden);
+    hash_destruir(hash);
+}
+
+/* Recorre todo el hash con el iterador externo, leyendo cada clave y dato. */
+static void medir_iterar(const hash_t *hash, const claves_t *claves)
+{
+    size_t suma = 0;
+    double inicio = segundos_actuales();
+    hash_iter_t iter;
+    for (hash_iter_iniciar(&iter, hash); !hash_iter_al_final(&iter); hash_iter_avanzar(&iter)) {
+        suma += (uintptr_t) hash_iter_ver_valor(&iter) + (size_t) hash_iter_ver_actual(&iter)[0];
+    }
+    double segundos = segundos_actuales() - inicio;
+    sumidero = suma;
+
+    informar("iterar", "-", claves->cantidad, claves->largo, claves->cantidad, segundos);
+}
+
+HASH_DEFINIR(hash_enteros, uint64_t, uint64_t, hash_generico_u64, hash_generico_igual_u64)
+
+/* Claves enteras en un hash_enteros_t, para comparar con las claves de 8
+ * caracteres del hash común. Las claves presentes son múltiplos de un primo
+ * grande y las ausentes, uno más que esos. */
+static void medir_enteros(size_t elementos, const size_t *indices)
+{
+    const uint64_t paso = 2654435761u;
+    double inicio = segundos_actuales();
+    hash_enteros_t *hash = hash_enteros_crear();
+    for (size_t i = 0; hash && i < elementos; i++) {
+        if (!hash_enteros_guardar(hash, i * paso, i + 1)) {
+            hash_enteros_destruir(hash);
+            hash = NULL;
+        }
+    }
+    double segundos = segundos_actuales() - inicio;
+    if (!hash) {
+        fprintf(stderr, "no hay memoria para %zu enteros\n", elementos);
+        return;
+    }
+    informar("insertar-entero", "-", elementos, sizeof(uint64_t), elementos, segundos);
+
+    for (uint64_t desplazamiento = 0; desplazamiento <= 1; desplazamiento++) {
+        const char *carga = desplazamiento ? "fallo-entero" : "acierto-entero";
+        size_t encontradas = 0;
+        inicio = segundos_actuales();
+        for (size_t i = 0; i < CONSULTAS; i++) {
+            encontradas += hash_enteros_obtener(hash, indices[i] * paso + desplazamiento) != NULL;
+        }
+        segundos = segundos_actuales() - inicio;
+        sumidero = encontradas;
+
+        if (encontradas != (desplazamiento ? 0 : CONSULTAS)) {
+            fprintf(stderr, "%s: se encontraron %zu claves de %d\n", carga, encontradas, CONSULTAS);
+        }
+        informar(carga, "uniforme", elementos, sizeof(uint64_t), CONSULTAS, segundos);
+    }
+    hash_enteros_destruir(hash);
+}
+
+/* Ejecuta todas las cargas con un hash de 'elementos' claves de 'largo' caracteres. */
+static void medir_todo(size_t elementos, size_t largo)
+{
+    claves_t claves;
+    size_t *uniformes = malloc(CONSULTAS * sizeof(size_t));
+    size_t *zipf = malloc(CONSULTAS * sizeof(size_t));
+    if (!uniformes || !zipf || !claves_crear(&claves, elementos, largo)) {
+        fprintf(stderr, "no hay memoria para %zu elementos\n", elementos);
+        free(uniformes);
+        free(zipf);
+        return;
+    }
+    if (!indices_generar(uniformes, CONSULTAS, elementos, false, 88172645463325252u) ||
+        !indices_generar(zipf, CONSULTAS, elementos, true, 88172645463325252u)) {
+        fprintf(stderr, "no hay memoria para %zu elementos\n", elementos);
+        free(claves.datos);
+        free(uniformes);
+        free(zipf);
+        return;
+    }
+
+    medir_insertar(&claves);
+
+    hash_t *hash = hash_llenar(&claves);
+    if (hash) {
+        medir_obtener(hash, &claves, uniformes, 0, "acierto", "uniforme");
+        medir_obtener(hash, &claves, zipf, 0, "acierto", "zipf");
+        medir_obtener_lote(hash, &claves, uniformes, "uniforme");
+        medir_obtener(hash, &claves, uniformes, elementos, "fallo", "uniforme");
+        medir_iterar(hash, &claves);
+        medir_congelado(hash, &claves, uniformes);
+        hash_destruir(hash);
+    }
+
+    if (largo == sizeof(uint64_t)) medir_enteros(elementos, uniformes);
+
+    medir_mixta(&claves, uniformes, "uniforme");
+    medir_mixta(&claves, zipf, "zipf");
+    medir_borrar(&claves);
+
+    free(claves.datos);
+    free(uniformes);
+    free(zipf);
+}
+
+/* ******************************************************************
+ *                        HASH CONCURRENTE
+ * *****************************************************************/
+
+/* Operaciones que hace un hilo de la prueba de escalado, sobre un hash
+ * concurrente o sobre un hash común protegido por un único mutex. */
+typedef struct carga {
+    hash_concurrente_t *concurrente;
+    hash_t *comun;
+    pthread_mutex_t *mutex;
+    size_t largo;
+    size_t operaciones;
+    uint64_t estado;
+} carga_t;
+
+/* Hace 'operaciones' consultas y reemplazos sobre claves al azar. */
+static void *ejecutar_carga(void *extra)
+{
+    carga_t *carga = extra;
+    char clave[LARGO_CLAVE_CONCURRENTE];
+
+    for (size_t i = 0; i < carga->operaciones; i++) {
+        uint64_t tirada = aleatorio(&carga->estado);
+        size_t indice = (size_t) (tirada % carga->largo);
+        bool escritura = (tirada >> 32) % 100 < PORCENTAJE_ESCRITURAS;
+        sprintf(clave, "%08zu", indice);
+
+        if (carga->concurrente && escritura) {
+            hash_concurrente_guardar(carga->concurrente, clave, NULL);
+        } else if (carga->concurrente) {
+            hash_concurrente_obtener(carga->concurrente, clave);
+        } else {
+            pthread_mutex_lock(carga->mutex);
+            if (escritura) hash_guardar(carga->comun, clave, NULL);
+            else hash_obtener(carga->comun, clave);
+            pthread_mutex_unlock(carga->mutex);
+        }
+    }
+    return NULL;
+}
+
+/* Devuelve millones de operaciones por segundo con 'hilos' hilos. */
+static double medir_carga(carga_t base, size_t hilos)
+{
+    pthread_t ids[MAXIMO_HILOS];
+    carga_t cargas[MAXIMO_HILOS];
+
+    double inicio = segundos_actuales();
+    for (size_t i = 0; i < hilos; i++) {
+        cargas[i] = base;
+        cargas[i].estado = 88172645463325252u + i;
+        pthread_create(&ids[i], NULL, ejecutar_carga, &cargas[i]);
+    }
+    for (size_t i = 0; i < hilos; i++) {
+        pthread_join(ids[i], NULL);
+    }
+    double transcurrido = segundos_actuales() - inicio;
+    return (double) (base.operaciones * hilos) / transcurrido / 1e6;
+}
+
+/* Compara el rendimiento de un hash común con un mutex global contra el hash
+ * concurrente, con 1, 2, 4 y 8 hilos haciendo un 90% de lecturas. */
+static void medir_concurrente(size_t largo)
+{
+    hash_concurrente_t *concurrente = hash_concurrente_crear(NULL);
+    hash_t *comun = hash_crear(NULL);
+    pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+    char clave[LARGO_CLAVE_CONCURRENTE];
+
+    bool ok = concurrente && comun;
+    for (size_t i = 0; i < largo && ok; i++) {
+        sprintf(clave, "%08zu", i);
+        ok = hash_concurrente_guardar(concurrente, clave, NULL) && hash_guardar(comun, clave, NULL);
+    }
+
+    carga_t base_comun = {NULL, comun, &mutex, largo, largo, 0};
+    carga_t base_concurrente = {concurrente, NULL, NULL, largo, largo, 0};
+
+    for (size_t hilos = 1; ok && hilos <= MAXIMO_HILOS; hilos *= 2) {
+        double comun_mops = medir_carga(base_comun, hilos);
+        double concurrente_mops = medir_carga(base_concurrente, hilos);
+        printf("%zu hilos: %6.2f Mops/s con mutex global, %6.2f Mops/s concurrente\n",
+               hilos, comun_mops, concurrente_mops);
+    }
+
+    if (comun) hash_destruir(comun);
+    if (concurrente) hash_concurrente_destruir(concurrente);
+}
+
+/* ******************************************************************
+ *                        PROGRAMA PRINCIPAL
+ * *****************************************************************/
+
+int main(int argc, char *argv[])
+{
+    if (argc > 1 && strcmp(argv[1], "concurrente") == 0) {
+        size_t largo = LARGO_CONCURRENTE;
+        if (argc > 2) largo = (size_t) strtol(argv[2], NULL, 10);
+        if (largo == 0) largo = LARGO_CONCURRENTE;
+        medir_concurrente(largo);
+        return 0;
+    }
+
+    size_t maximo = MAXIMO_DEFECTO;
+    if (argc > 1) maximo = (size_t) strtol(argv[1], NULL, 10);
+
+    printf("%-17s %-9s %10s %6s %10s %10s\n",
+           "carga", "claves", "elementos", "largo", "ns/op", "Mops/s");
+    for (size_t elementos = 1000; elementos <= maximo; elementos *= 10) {
+        for (size_t i = 0; i < sizeof(LARGOS_CLAVE) / sizeof(LARGOS_CLAVE[0]); i++) {
+            medir_todo(elementos, LARGOS_CLAVE[i]);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,148 @@
+#define _POSIX_C_SOURCE 200809L
+#include "hash_concurrente.h"
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BITS_SEGMENTOS 6
+#define CANTIDAD_SEGMENTOS (1 << BITS_SEGMENTOS)
+#define TAM_LINEA_CACHE 64
+
+/* Definiciones previas:
+    Segmentos: cada segmento es un hash_t común protegido por un pthread_rwlock_t.
+            Los bits más altos del hash de la clave eligen el segmento; como el hash
+            de cada segmento usa la misma función y semilla, pero toma sus posiciones
+            de los bits bajos, el reparto entre segmentos no empeora la distribución
+            dentro de cada uno.
+*/
+
+/* Definición del struct segmento */
+typedef struct segmento {
+    pthread_rwlock_t lock;
+    hash_t* hash;
+} segmento_t;
+
+/* Segmento rellenado hasta ocupar líneas de caché completas, para que dos hilos
+trabajando en segmentos vecinos no se disputen la misma línea. */
+typedef union segmento_alineado {
+    segmento_t segmento;
+    char relleno[(sizeof(segmento_t) + TAM_LINEA_CACHE - 1) / TAM_LINEA_CACHE * TAM_LINEA_CACHE];
+} segmento_alineado_t;
+
+/* Definición del struct hash concurrente */
+struct hash_concurrente {
+    segmento_alineado_t segmentos[CANTIDAD_SEGMENTOS];
+    uint64_t semilla;
+};
+
+/***************************
+* Funciones auxiliares
+****************************/
+
+/* Devuelve el segmento en el que se guarda la clave y deja en num_hash su hash,
+para que el segmento no tenga que volver a calcularlo. */
+segmento_t *hash_concurrente_segmento(hash_concurrente_t *hash, const char *clave,
+                                      size_t largo, uint64_t *num_hash){
+    *num_hash = hash_funcion_defecto(clave, largo, hash->semilla);
+    return &hash->segmentos[*num_hash >> (64 - BITS_SEGMENTOS)].segmento;
+}
+
+/***************************
+* Primitivas del Hash Concurrente
+****************************/
+
+hash_concurrente_t *hash_concurrente_crear(hash_destruir_dato_t destruir_dato){
+    // Con malloc el arreglo de segmentos sólo queda alineado a 16 bytes, y el
+    // relleno no alcanzaría para que cada segmento ocupe sus propias líneas.
+    hash_concurrente_t* hash;
+    if (posix_memalign((void**)&hash, TAM_LINEA_CACHE, sizeof(hash_concurrente_t)) != 0){
+        return NULL;
+    }
+
+    hash->semilla = hash_semilla_aleatoria();
+
+    for (size_t i = 0; i < CANTIDAD_SEGMENTOS; i++){
+        segmento_t* segmento = &hash->segmentos[i].segmento;
+        segmento->hash = hash_crear_con_funcion(destruir_dato, hash_funcion_defecto, hash->semilla);
+
+        if (!segmento->hash || pthread_rwlock_init(&segmento->lock, NULL) != 0){
+            if (segmento->hash) hash_destruir(segmento->hash);
+            for (size_t j = 0; j < i; j++){
+                pthread_rwlock_destroy(&hash->segmentos[j].segmento.lock);
+                hash_destruir(hash->segmentos[j].segmento.hash);
+            }
+            free(hash);
+            return NULL;
+        }
+    }
+    return hash;
+}
+
+bool hash_concurrente_guardar(hash_concurrente_t *hash, const char *clave, void *dato){
+    if (!clave) return false;
+    size_t largo = strlen(clave);
+    uint64_t num_hash;
+    segmento_t* segmento = hash_concurrente_segmento(hash, clave, largo, &num_hash);
+
+    pthread_rwlock_wrlock(&segmento->lock);
+    bool guardado = hash_guardar_con_hash(segmento->hash, clave, largo, num_hash, dato);
+    pthread_rwlock_unlock(&segmento->lock);
+    return guardado;
+}
+
+void *hash_concurrente_borrar(hash_concurrente_t *hash, const char *clave){
+    if (!clave) return NULL;
+    size_t largo = strlen(clave);
+    uint64_t num_hash;
+    segmento_t* segmento = hash_concurrente_segmento(hash, clave, largo, &num_hash);
+
+    pthread_rwlock_wrlock(&segmento->lock);
+    void* dato = hash_borrar_con_hash(segmento->hash, clave, largo, num_hash);
+    pthread_rwlock_unlock(&segmento->lock);
+    return dato;
+}
+
+void *hash_concurrente_obtener(hash_concurrente_t *hash, const char *clave){
+    if (!clave) return NULL;
+    size_t largo = strlen(clave);
+    uint64_t num_hash;
+    segmento_t* segmento = hash_concurrente_segmento(hash, clave, largo, &num_hash);
+
+    pthread_rwlock_rdlock(&segmento->lock);
+    void* dato = hash_obtener_con_hash(segmento->hash, clave, largo, num_hash);
+    pthread_rwlock_unlock(&segmento->lock);
+    return dato;
+}
+
+bool hash_concurrente_pertenece(hash_concurrente_t *hash, const char *clave){
+    if (!clave) return false;
+    size_t largo = strlen(clave);
+    uint64_t num_hash;
+    segmento_t* segmento = hash_concurrente_segmento(hash, clave, largo, &num_hash);
+
+    pthread_rwlock_rdlock(&segmento->lock);
+    bool pertenece = hash_pertenece_con_hash(segmento->hash, clave, largo, num_hash);
+    pthread_rwlock_unlock(&segmento->lock);
+    return pertenece;
+}
+
+size_t hash_concurrente_cantidad(hash_concurrente_t *hash){
+    size_t cantidad = 0;
+
+    for (size_t i = 0; i < CANTIDAD_SEGMENTOS; i++){
+        segmento_t* segmento = &hash->segmentos[i].segmento;
+        pthread_rwlock_rdlock(&segmento->lock);
+        cantidad += hash_cantidad(segmento->hash);
+        pthread_rwlock_unlock(&segmento->lock);
+    }
+    return cantidad;
+}
+
+void hash_concurrente_destruir(hash_concurrente_t *hash){
+    for (size_t i = 0; i < CANTIDAD_SEGMENTOS; i++){
+        pthread_rwlock_destroy(&hash->segmentos[i].segmento.lock);
+        hash_destruir(hash->segmentos[i].segmento.hash);
+    }
+    free(hash);
+}
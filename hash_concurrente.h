@@ -0,0 +1,47 @@
+#ifndef HASH_CONCURRENTE_H
+#define HASH_CONCURRENTE_H
+
+#include "hash.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/* Hash que puede usarse desde varios hilos a la vez. Las claves se reparten
+ * entre segmentos, cada uno con su propio hash y su propio lock de lectura y
+ * escritura: las lecturas de un mismo segmento no se bloquean entre sí, y las
+ * operaciones sobre segmentos distintos no se bloquean en absoluto. */
+struct hash_concurrente;
+typedef struct hash_concurrente hash_concurrente_t;
+
+/* Crea el hash concurrente. Devuelve NULL si no pudo crearlo.
+ */
+hash_concurrente_t *hash_concurrente_crear(hash_destruir_dato_t destruir_dato);
+
+/* Mismas semánticas que hash_guardar, hash_borrar, hash_obtener y
+ * hash_pertenece; cada operación es atómica respecto de las demás.
+ * El dato devuelto por hash_concurrente_obtener sigue siendo del hash: si
+ * otro hilo reemplaza o borra la clave, puede ser destruido mientras se lo
+ * usa. Quien necesite usarlo fuera del hash debe coordinarlo por su cuenta.
+ * Pre: La estructura hash fue inicializada
+ */
+bool hash_concurrente_guardar(hash_concurrente_t *hash, const char *clave, void *dato);
+void *hash_concurrente_borrar(hash_concurrente_t *hash, const char *clave);
+void *hash_concurrente_obtener(hash_concurrente_t *hash, const char *clave);
+bool hash_concurrente_pertenece(hash_concurrente_t *hash, const char *clave);
+
+/* Devuelve la cantidad de elementos del hash. Los segmentos se cuentan de a
+ * uno, tomando sólo el lock de cada uno mientras se lo cuenta: si otros hilos
+ * están modificando el hash, el resultado es aproximado y puede no coincidir
+ * con la cantidad que hubo en ningún momento del llamado. Sin escrituras
+ * concurrentes es exacto.
+ * Pre: La estructura hash fue inicializada
+ */
+size_t hash_concurrente_cantidad(hash_concurrente_t *hash);
+
+/* Destruye la estructura igual que hash_destruir.
+ * Pre: La estructura hash fue inicializada y ningún otro hilo la está usando
+ * Post: La estructura hash fue destruida
+ */
+void hash_concurrente_destruir(hash_concurrente_t *hash);
+
+#endif // HASH_CONCURRENTE_H
@@ -0,0 +1,123 @@
+/*
+ * hash_concurrente_pruebas.c
+ * Pruebas para el hash concurrente
+ */
+
+#include "hash_concurrente.h"
+#include "testing.h"
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define HILOS_PRUEBA 4
+#define LARGO_CLAVE 24
+
+/* ******************************************************************
+ *                        PRUEBAS UNITARIAS
+ * *****************************************************************/
+
+typedef struct tarea {
+    hash_concurrente_t *hash;
+    size_t desde;
+    size_t hasta;
+    bool ok;
+} tarea_t;
+
+static void *guardar_rango(void *extra)
+{
+    tarea_t *tarea = extra;
+    char clave[LARGO_CLAVE];
+
+    tarea->ok = true;
+    for (size_t i = tarea->desde; i < tarea->hasta && tarea->ok; i++) {
+        sprintf(clave, "%08zu", i);
+        tarea->ok = hash_concurrente_guardar(tarea->hash, clave, (void *) (uintptr_t) (i + 1));
+    }
+    return NULL;
+}
+
+static void *borrar_rango(void *extra)
+{
+    tarea_t *tarea = extra;
+    char clave[LARGO_CLAVE];
+
+    tarea->ok = true;
+    for (size_t i = tarea->desde; i < tarea->hasta && tarea->ok; i++) {
+        sprintf(clave, "%08zu", i);
+        tarea->ok = hash_concurrente_borrar(tarea->hash, clave) == (void *) (uintptr_t) (i + 1);
+    }
+    return NULL;
+}
+
+/* Ejecuta la función en HILOS_PRUEBA hilos, cada uno sobre una parte de [0, largo).
+ * Devuelve true si todos los hilos terminaron bien. */
+static bool ejecutar_en_hilos(hash_concurrente_t *hash, size_t largo, void *(*funcion)(void *))
+{
+    pthread_t hilos[HILOS_PRUEBA];
+    tarea_t tareas[HILOS_PRUEBA];
+
+    for (size_t i = 0; i < HILOS_PRUEBA; i++) {
+        tareas[i] = (tarea_t) {hash, largo * i / HILOS_PRUEBA, largo * (i + 1) / HILOS_PRUEBA, false};
+        pthread_create(&hilos[i], NULL, funcion, &tareas[i]);
+    }
+
+    bool ok = true;
+    for (size_t i = 0; i < HILOS_PRUEBA; i++) {
+        pthread_join(hilos[i], NULL);
+        ok = ok && tareas[i].ok;
+    }
+    return ok;
+}
+
+static void prueba_hash_concurrente_basico()
+{
+    hash_concurrente_t *hash = hash_concurrente_crear(NULL);
+    char *clave = "perro", *valor1 = "guau", *valor2 = "warf";
+
+    print_test("Prueba hash concurrente crear", hash);
+    print_test("Prueba hash concurrente la cantidad de elementos es 0", hash_concurrente_cantidad(hash) == 0);
+    print_test("Prueba hash concurrente obtener clave ausente es NULL", !hash_concurrente_obtener(hash, clave));
+    print_test("Prueba hash concurrente insertar clave", hash_concurrente_guardar(hash, clave, valor1));
+    print_test("Prueba hash concurrente reemplazar clave", hash_concurrente_guardar(hash, clave, valor2));
+    print_test("Prueba hash concurrente obtener clave es valor2", hash_concurrente_obtener(hash, clave) == valor2);
+    print_test("Prueba hash concurrente pertenece clave", hash_concurrente_pertenece(hash, clave));
+    print_test("Prueba hash concurrente la cantidad de elementos es 1", hash_concurrente_cantidad(hash) == 1);
+    print_test("Prueba hash concurrente borrar clave es valor2", hash_concurrente_borrar(hash, clave) == valor2);
+    print_test("Prueba hash concurrente pertenece clave borrada, es false", !hash_concurrente_pertenece(hash, clave));
+    print_test("Prueba hash concurrente guardar clave NULL es false", !hash_concurrente_guardar(hash, NULL, valor1));
+
+    hash_concurrente_destruir(hash);
+}
+
+static void prueba_hash_concurrente_volumen(size_t largo)
+{
+    hash_concurrente_t *hash = hash_concurrente_crear(NULL);
+    char clave[LARGO_CLAVE];
+
+    print_test("Prueba hash concurrente guardar desde varios hilos", ejecutar_en_hilos(hash, largo, guardar_rango));
+    print_test("Prueba hash concurrente la cantidad de elementos es correcta", hash_concurrente_cantidad(hash) == largo);
+
+    bool ok = true;
+    for (size_t i = 0; i < largo && ok; i++) {
+        sprintf(clave, "%08zu", i);
+        ok = hash_concurrente_obtener(hash, clave) == (void *) (uintptr_t) (i + 1);
+    }
+    print_test("Prueba hash concurrente obtener todos los elementos", ok);
+
+    print_test("Prueba hash concurrente borrar desde varios hilos", ejecutar_en_hilos(hash, largo, borrar_rango));
+    print_test("Prueba hash concurrente la cantidad de elementos es 0", hash_concurrente_cantidad(hash) == 0);
+
+    hash_concurrente_destruir(hash);
+}
+
+/* ******************************************************************
+ *                        FUNCIÓN PRINCIPAL
+ * *****************************************************************/
+
+void pruebas_hash_concurrente()
+{
+    prueba_hash_concurrente_basico();
+    prueba_hash_concurrente_volumen(20000);
+}
@@ -0,0 +1,290 @@
+#include "hash_congelado.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CLAVES_POR_CUBETA 4
+#define HOLGURA_TABLA 64
+#define PILOTOS_MAXIMOS 65536
+#define INTENTOS_MAXIMOS 16
+
+/* Definiciones previas:
+    Cubeta: grupo de claves con el mismo valor de num_hash reducido a la
+            cantidad de cubetas (cantidad / CLAVES_POR_CUBETA en promedio).
+    Piloto: número de cada cubeta que, combinado con el num_hash de cada una de
+            sus claves, da la posición de la clave. Al armar el hash se busca,
+            de la cubeta más grande a la más chica, el primer piloto que lleva
+            todas sus claves a posiciones libres y distintas.
+    Posiciones: se eligen entre tam_tabla, un poco más que la cantidad de
+            claves, porque encontrar pilotos para las últimas cubetas con
+            exactamente cantidad posiciones requeriría demasiados intentos. Las
+            claves que caen en una posición mayor o igual a la cantidad se
+            mueven a uno de los huecos que quedaron debajo (libres), así que
+            el arreglo de entradas no tiene huecos.
+*/
+
+/* Definición del struct entrada */
+typedef struct entrada {
+    uint64_t num_hash;
+    size_t desplazamiento;  // de la clave en claves
+    size_t largo;
+    void* dato;
+} entrada_t;
+
+/* Definición del struct hash congelado */
+struct hash_congelado {
+    uint64_t semilla;
+    size_t cantidad;
+    size_t cubetas;
+    size_t tam_tabla;
+    uint16_t* pilotos;      // uno por cubeta
+    size_t* libres;         // uno por posición entre cantidad y tam_tabla
+    entrada_t* entradas;    // cantidad
+    char* claves;
+    size_t largo_claves;
+};
+
+/***************************
+* Funciones auxiliares
+****************************/
+
+/* Lleva x de [0, 2^64) a [0, n) sin dividir. */
+static inline size_t reducir(uint64_t x, size_t n){
+    __extension__ unsigned __int128 r = (unsigned __int128)x * n;
+    return (size_t)(r >> 64);
+}
+
+/* Posición de una clave con el num_hash dado si su cubeta tiene ese piloto. */
+static inline size_t congelado_posicion(uint64_t num_hash, uint64_t piloto, size_t tam_tabla){
+    uint64_t x = num_hash ^ (piloto * 0x9e3779b97f4a7c15ULL);
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    x ^= x >> 33;
+    return reducir(x, tam_tabla);
+}
+
+/* Devuelve la entrada en la que estaría la clave, sin compararla. */
+static inline const entrada_t* congelado_entrada(const hash_congelado_t* congelado, uint64_t num_hash){
+    size_t piloto = congelado->pilotos[reducir(num_hash, congelado->cubetas)];
+    size_t posicion = congelado_posicion(num_hash, piloto, congelado->tam_tabla);
+    if (posicion >= congelado->cantidad){
+        posicion = congelado->libres[posicion - congelado->cantidad];
+    }
+    return &congelado->entradas[posicion];
+}
+
+/* Copia las claves del hash a congelado->claves y deja en entradas, en el
+orden del iterador, dónde quedó cada una y su dato. */
+void congelado_copiar(hash_congelado_t* congelado, const hash_t* hash, entrada_t* entradas){
+    hash_iter_t iter;
+    hash_iter_iniciar(&iter, hash);
+    size_t i = 0, desplazamiento = 0;
+    for (; !hash_iter_al_final(&iter); hash_iter_avanzar(&iter), i++){
+        size_t largo;
+        const void* clave = hash_iter_ver_actual_n(&iter, &largo);
+        memcpy(congelado->claves + desplazamiento, clave, largo);
+        entradas[i] = (entrada_t){0, desplazamiento, largo, hash_iter_ver_valor(&iter)};
+        desplazamiento += largo;
+    }
+}
+
+/* Busca un piloto para cada cubeta con la semilla actual, de la cubeta más
+grande a la más chica. Deja en posiciones la posición de cada entrada (en
+[0, tam_tabla)). Devuelve false si alguna cubeta no tiene piloto; en ese caso
+hay que probar con otra semilla. */
+bool congelado_buscar_pilotos(hash_congelado_t* congelado, const entrada_t* entradas, size_t* posiciones){
+    size_t n = congelado->cantidad, cubetas = congelado->cubetas;
+    size_t* inicio = calloc(cubetas + 1, sizeof(size_t));  // inicio de cada cubeta en orden
+    size_t* orden = malloc((n + 1) * sizeof(size_t));      // entradas agrupadas por cubeta
+    bool* ocupada = calloc(congelado->tam_tabla, sizeof(bool));
+    bool ok = inicio && orden && ocupada;
+
+    // Agrupa las entradas por cubeta (ordenamiento por conteo).
+    size_t tam_maximo = 0;
+    for (size_t i = 0; ok && i < n; i++){
+        inicio[reducir(entradas[i].num_hash, cubetas) + 1]++;
+    }
+    for (size_t c = 0; ok && c < cubetas; c++){
+        if (inicio[c + 1] > tam_maximo) tam_maximo = inicio[c + 1];
+        inicio[c + 1] += inicio[c];
+    }
+    size_t* siguiente = ok ? malloc(cubetas * sizeof(size_t)) : NULL;
+    size_t* por_tamanio = ok ? calloc(tam_maximo + 2, sizeof(size_t)) : NULL;
+    size_t* cubetas_ordenadas = ok ? malloc(cubetas * sizeof(size_t)) : NULL;
+    ok = ok && siguiente && por_tamanio && cubetas_ordenadas;
+
+    if (ok){
+        memcpy(siguiente, inicio, cubetas * sizeof(size_t));
+        for (size_t i = 0; i < n; i++){
+            orden[siguiente[reducir(entradas[i].num_hash, cubetas)]++] = i;
+        }
+
+        // Ordena las cubetas de mayor a menor tamaño (también por conteo).
+        for (size_t c = 0; c < cubetas; c++){
+            por_tamanio[tam_maximo - (inicio[c + 1] - inicio[c]) + 1]++;
+        }
+        for (size_t t = 0; t <= tam_maximo; t++){
+            por_tamanio[t + 1] += por_tamanio[t];
+        }
+        for (size_t c = 0; c < cubetas; c++){
+            cubetas_ordenadas[por_tamanio[tam_maximo - (inicio[c + 1] - inicio[c])]++] = c;
+        }
+    }
+
+    for (size_t k = 0; ok && k < cubetas; k++){
+        size_t c = cubetas_ordenadas[k];
+        if (inicio[c] == inicio[c + 1]){
+            break;                                  // las que siguen también están vacías
+        }
+
+        ok = false;
+        for (size_t piloto = 0; !ok && piloto < PILOTOS_MAXIMOS; piloto++){
+            size_t j = inicio[c];
+            for (; j < inicio[c + 1]; j++){
+                size_t posicion = congelado_posicion(entradas[orden[j]].num_hash, piloto, congelado->tam_tabla);
+                if (ocupada[posicion]) break;
+                ocupada[posicion] = true;
+                posiciones[orden[j]] = posicion;
+            }
+            ok = j == inicio[c + 1];
+            // Si alguna clave chocó, se liberan las posiciones que tomaron las anteriores.
+            for (size_t l = inicio[c]; !ok && l < j; l++){
+                ocupada[posiciones[orden[l]]] = false;
+            }
+            if (ok) congelado->pilotos[c] = (uint16_t)piloto;
+        }
+    }
+
+    // Asigna a cada posición ocupada a partir de cantidad uno de los huecos de
+    // abajo. Las desocupadas sólo las alcanzan claves ausentes, que fallan al
+    // compararse con cualquier entrada: apuntan a la primera.
+    for (size_t p = n, hueco = 0; ok && p < congelado->tam_tabla; p++){
+        congelado->libres[p - n] = 0;
+        if (!ocupada[p]) continue;
+        while (ocupada[hueco]) hueco++;
+        congelado->libres[p - n] = hueco++;
+    }
+
+    free(cubetas_ordenadas);
+    free(por_tamanio);
+    free(siguiente);
+    free(ocupada);
+    free(orden);
+    free(inicio);
+    return ok;
+}
+
+/***************************
+* Primitivas del Hash Congelado
+****************************/
+
+hash_congelado_t *hash_congelar(const hash_t *hash){
+    hash_congelado_t* congelado = calloc(1, sizeof(hash_congelado_t));
+    if (!congelado){
+        return NULL;
+    }
+
+    size_t n = hash_cantidad(hash);
+    hash_iter_t iter;
+    hash_iter_iniciar(&iter, hash);
+    for (; !hash_iter_al_final(&iter); hash_iter_avanzar(&iter)){
+        size_t largo;
+        hash_iter_ver_actual_n(&iter, &largo);
+        congelado->largo_claves += largo;
+    }
+
+    congelado->cantidad = n;
+    congelado->cubetas = n / CLAVES_POR_CUBETA + 1;
+    congelado->tam_tabla = n + n / HOLGURA_TABLA + 1;
+    congelado->pilotos = calloc(congelado->cubetas, sizeof(uint16_t));
+    congelado->libres = malloc((congelado->tam_tabla - n) * sizeof(size_t));
+    congelado->entradas = malloc((n + 1) * sizeof(entrada_t));
+    congelado->claves = malloc(congelado->largo_claves + 1);
+    entrada_t* entradas = malloc((n + 1) * sizeof(entrada_t));
+    size_t* posiciones = malloc((n + 1) * sizeof(size_t));
+
+    bool ok = congelado->pilotos && congelado->libres && congelado->entradas &&
+              congelado->claves && entradas && posiciones;
+    if (ok){
+        congelado_copiar(congelado, hash, entradas);
+        ok = false;
+    }
+
+    // Con una semilla al azar casi siempre alcanza el primer intento.
+    for (size_t intento = 0; !ok && intento < INTENTOS_MAXIMOS && posiciones; intento++){
+        congelado->semilla = hash_semilla_aleatoria();
+        for (size_t i = 0; i < n; i++){
+            entradas[i].num_hash = hash_funcion_defecto(congelado->claves + entradas[i].desplazamiento,
+                                                        entradas[i].largo, congelado->semilla);
+        }
+        memset(congelado->pilotos, 0, congelado->cubetas * sizeof(uint16_t));
+        ok = congelado_buscar_pilotos(congelado, entradas, posiciones);
+    }
+
+    for (size_t i = 0; ok && i < n; i++){
+        size_t posicion = posiciones[i];
+        if (posicion >= n) posicion = congelado->libres[posicion - n];
+        congelado->entradas[posicion] = entradas[i];
+    }
+
+    free(posiciones);
+    free(entradas);
+    if (!ok){
+        hash_congelado_destruir(congelado);
+        return NULL;
+    }
+    return congelado;
+}
+
+void *hash_congelado_obtener(const hash_congelado_t *congelado, const char *clave){
+    if (!clave) return NULL;
+    return hash_congelado_obtener_n(congelado, clave, strlen(clave));
+}
+
+bool hash_congelado_pertenece(const hash_congelado_t *congelado, const char *clave){
+    if (!clave) return false;
+    return hash_congelado_pertenece_n(congelado, clave, strlen(clave));
+}
+
+void *hash_congelado_obtener_n(const hash_congelado_t *congelado, const void *clave, size_t largo){
+    if (congelado->cantidad == 0 || !clave){
+        return NULL;
+    }
+    uint64_t num_hash = hash_funcion_defecto(clave, largo, congelado->semilla);
+    const entrada_t* entrada = congelado_entrada(congelado, num_hash);
+    if (entrada->num_hash != num_hash || entrada->largo != largo ||
+        memcmp(congelado->claves + entrada->desplazamiento, clave, largo) != 0){
+        return NULL;
+    }
+    return entrada->dato;
+}
+
+bool hash_congelado_pertenece_n(const hash_congelado_t *congelado, const void *clave, size_t largo){
+    if (congelado->cantidad == 0 || !clave){
+        return false;
+    }
+    uint64_t num_hash = hash_funcion_defecto(clave, largo, congelado->semilla);
+    const entrada_t* entrada = congelado_entrada(congelado, num_hash);
+    return entrada->num_hash == num_hash && entrada->largo == largo &&
+           memcmp(congelado->claves + entrada->desplazamiento, clave, largo) == 0;
+}
+
+size_t hash_congelado_cantidad(const hash_congelado_t *congelado){
+    return congelado->cantidad;
+}
+
+size_t hash_congelado_memoria(const hash_congelado_t *congelado){
+    return sizeof(hash_congelado_t) + congelado->cubetas * sizeof(uint16_t) +
+           (congelado->tam_tabla - congelado->cantidad) * sizeof(size_t) +
+           congelado->cantidad * sizeof(entrada_t) + congelado->largo_claves;
+}
+
+void hash_congelado_destruir(hash_congelado_t *congelado){
+    free(congelado->pilotos);
+    free(congelado->libres);
+    free(congelado->entradas);
+    free(congelado->claves);
+    free(congelado);
+}
@@ -0,0 +1,46 @@
+#ifndef HASH_CONGELADO_H
+#define HASH_CONGELADO_H
+
+#include "hash.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/* Hash de sólo lectura armado a partir de un hash_t con una función de hash
+ * perfecta mínima: cada clave guardada tiene su propia posición en un arreglo
+ * de exactamente tantas entradas como claves, así que una búsqueda mira una
+ * sola entrada y compara una sola clave, y no sobra lugar en la tabla. */
+
+typedef struct hash_congelado hash_congelado_t;
+
+/* Arma un hash congelado con los pares que tiene el hash en este momento.
+ * Las claves se copian; los datos no: el hash congelado guarda los mismos
+ * punteros y nunca los destruye. Devuelve NULL si no hubo memoria.
+ * Pre: La estructura hash fue inicializada.
+ * Post: Los cambios posteriores al hash no se ven en el hash congelado.
+ */
+hash_congelado_t *hash_congelar(const hash_t *hash);
+
+/* Igual que hash_obtener y hash_pertenece, sobre un hash congelado.
+ */
+void *hash_congelado_obtener(const hash_congelado_t *congelado, const char *clave);
+bool hash_congelado_pertenece(const hash_congelado_t *congelado, const char *clave);
+
+/* Igual que las anteriores, para claves de largo bytes arbitrarios.
+ */
+void *hash_congelado_obtener_n(const hash_congelado_t *congelado, const void *clave, size_t largo);
+bool hash_congelado_pertenece_n(const hash_congelado_t *congelado, const void *clave, size_t largo);
+
+/* Devuelve la cantidad de pares del hash congelado.
+ */
+size_t hash_congelado_cantidad(const hash_congelado_t *congelado);
+
+/* Devuelve los bytes de memoria que ocupa el hash congelado, claves incluidas.
+ */
+size_t hash_congelado_memoria(const hash_congelado_t *congelado);
+
+/* Destruye el hash congelado. Los datos no se destruyen.
+ */
+void hash_congelado_destruir(hash_congelado_t *congelado);
+
+#endif // HASH_CONGELADO_H
@@ -0,0 +1,113 @@
+/*
+ * hash_congelado_pruebas.c
+ * Pruebas para el hash congelado
+ */
+
+#include "hash_congelado.h"
+#include "testing.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define LARGO_CLAVE 48
+
+/* ******************************************************************
+ *                        PRUEBAS UNITARIAS
+ * *****************************************************************/
+
+static void prueba_congelado_vacio(void)
+{
+    hash_t *hash = hash_crear(NULL);
+    hash_congelado_t *congelado = hash_congelar(hash);
+
+    print_test("Prueba congelado vacío se creó", congelado);
+    print_test("Prueba congelado vacío la cantidad es 0", hash_congelado_cantidad(congelado) == 0);
+    print_test("Prueba congelado vacío obtener es NULL", !hash_congelado_obtener(congelado, "A"));
+    print_test("Prueba congelado vacío pertenece es false", !hash_congelado_pertenece(congelado, ""));
+
+    hash_congelado_destruir(congelado);
+    hash_destruir(hash);
+}
+
+static void prueba_congelado_basico(void)
+{
+    hash_t *hash = hash_crear(NULL);
+    char *dato = "dato";
+    hash_guardar(hash, "clave", dato);
+    hash_guardar(hash, "", dato + 1);
+    hash_guardar(hash, "nulo", NULL);
+    hash_guardar_n(hash, "a\0b", 3, dato + 2);
+
+    hash_congelado_t *congelado = hash_congelar(hash);
+    print_test("Prueba congelado se creó", congelado);
+    print_test("Prueba congelado la cantidad es 4", hash_congelado_cantidad(congelado) == 4);
+    print_test("Prueba congelado obtener clave", hash_congelado_obtener(congelado, "clave") == dato);
+    print_test("Prueba congelado obtener clave vacía", hash_congelado_obtener(congelado, "") == dato + 1);
+    print_test("Prueba congelado pertenece con dato NULL", hash_congelado_pertenece(congelado, "nulo"));
+    print_test("Prueba congelado obtener con dato NULL es NULL", !hash_congelado_obtener(congelado, "nulo"));
+    print_test("Prueba congelado obtener clave con bytes nulos", hash_congelado_obtener_n(congelado, "a\0b", 3) == dato + 2);
+    print_test("Prueba congelado la clave hasta el byte nulo no pertenece", !hash_congelado_pertenece(congelado, "a"));
+    print_test("Prueba congelado un prefijo no pertenece", !hash_congelado_pertenece_n(congelado, "clave", 4));
+    print_test("Prueba congelado obtener clave NULL es NULL", !hash_congelado_obtener(congelado, NULL));
+    print_test("Prueba congelado pertenece clave NULL es false", !hash_congelado_pertenece(congelado, NULL));
+
+    // El hash congelado copia las claves: no cambia si el hash cambia.
+    hash_borrar(hash, "clave");
+    hash_guardar(hash, "otra", dato);
+    print_test("Prueba congelado sigue teniendo la clave borrada del hash", hash_congelado_obtener(congelado, "clave") == dato);
+    print_test("Prueba congelado no tiene la clave nueva del hash", !hash_congelado_pertenece(congelado, "otra"));
+
+    hash_destruir(hash);
+    print_test("Prueba congelado sigue valiendo sin el hash", hash_congelado_obtener(congelado, "clave") == dato);
+    hash_congelado_destruir(congelado);
+}
+
+static void prueba_congelado_volumen(size_t largo)
+{
+    hash_t *hash = hash_crear(NULL);
+    char clave[LARGO_CLAVE];
+
+    for (size_t i = 0; i < largo; i++) {
+        sprintf(clave, i % 10 ? "%08zu" : "clave larga del hash congelado %08zu", i);
+        hash_guardar(hash, clave, (void *) (uintptr_t) (i + 1));
+    }
+
+    hash_congelado_t *congelado = hash_congelar(hash);
+    print_test("Prueba congelado volumen se creó", congelado);
+    print_test("Prueba congelado volumen la cantidad es correcta", congelado && hash_congelado_cantidad(congelado) == largo);
+
+    bool ok = congelado != NULL;
+    for (size_t i = 0; i < largo && ok; i++) {
+        sprintf(clave, i % 10 ? "%08zu" : "clave larga del hash congelado %08zu", i);
+        ok = hash_congelado_pertenece(congelado, clave) &&
+             hash_congelado_obtener(congelado, clave) == (void *) (uintptr_t) (i + 1);
+    }
+    print_test("Prueba congelado volumen obtener todas las claves", ok);
+
+    for (size_t i = largo; i < 2 * largo && ok; i++) {
+        sprintf(clave, i % 10 ? "%08zu" : "clave larga del hash congelado %08zu", i);
+        ok = !hash_congelado_pertenece(congelado, clave) && !hash_congelado_obtener(congelado, clave);
+    }
+    print_test("Prueba congelado volumen las claves ausentes no pertenecen", ok);
+
+    // Por clave: una entrada (32 bytes), los bytes de la clave y menos de un byte de pilotos y huecos.
+    size_t memoria = congelado ? hash_congelado_memoria(congelado) : 0;
+    hash_estadisticas_t estadisticas;
+    hash_estadisticas(hash, &estadisticas);
+    print_test("Prueba congelado volumen ocupa menos memoria que el hash", memoria < estadisticas.bytes_totales);
+
+    if (congelado) hash_congelado_destruir(congelado);
+    hash_destruir(hash);
+}
+
+/* ******************************************************************
+ *                        FUNCIÓN PRINCIPAL
+ * *****************************************************************/
+
+void pruebas_hash_congelado()
+{
+    prueba_congelado_vacio();
+    prueba_congelado_basico();
+    prueba_congelado_volumen(50000);
+}
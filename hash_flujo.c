@@ -0,0 +1,316 @@
+#define _POSIX_C_SOURCE 200809L
+#include "hash_flujo.h"
+#include <errno.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define FLUJO_MAGIA "HASHFLJ1"
+#define LARGO_MAGIA 8
+#define TAM_BUFFER_FD 65536
+#define RESERVA_FLUJO 65536
+
+/* Definiciones previas:
+    Flujo: LARGO_MAGIA bytes de FLUJO_MAGIA, la cantidad de pares (uint64_t) y un
+            registro por par: largo de la clave y largo del dato (uint64_t), la
+            clave y los bytes del dato, sin relleno entre ellos.
+    Escritor / Lector: buffer de tamaño fijo entre el hash y la función del
+            usuario. Los pedazos que no entran en el buffer no se copian: se
+            pasan directo a la función, así que la memoria usada no depende
+            del tamaño de los pares.
+    Conocidos: bytes que el lector sabe que al flujo todavía le quedan (el
+            encabezado, el resto del registro actual y los largos del
+            siguiente). El lector nunca le pide a la función más que eso, así
+            que no consume bytes que siguen al flujo, como los de otro flujo
+            escrito a continuación en el mismo archivo, ni espera bytes que no
+            van a llegar por un pipe o un socket que queda abierto.
+*/
+
+/* Definición del struct escritor */
+typedef struct escritor {
+    char *buffer;
+    size_t tam;
+    size_t usados;
+    hash_flujo_escribir_t escribir;
+    void *extra;
+} escritor_t;
+
+/* Definición del struct lector */
+typedef struct lector {
+    char *buffer;
+    size_t tam;
+    size_t inicio;
+    size_t fin;
+    size_t conocidos;
+    hash_flujo_leer_t leer;
+    void *extra;
+} lector_t;
+
+/***************************
+* Funciones auxiliares del Escritor
+****************************/
+
+/* Pasa a la función del usuario lo que haya en el buffer. */
+bool escritor_vaciar(escritor_t *escritor){
+    if (escritor->usados == 0){
+        return true;
+    }
+    bool ok = escritor->escribir(escritor->buffer, escritor->usados, escritor->extra);
+    escritor->usados = 0;
+    return ok;
+}
+
+/* Agrega bytes al flujo; si no entran en el buffer lo vacía primero y, si
+tampoco entran en un buffer vacío, los pasa directo. */
+bool escritor_agregar(escritor_t *escritor, const void *bytes, size_t largo){
+    if (largo > escritor->tam - escritor->usados && !escritor_vaciar(escritor)){
+        return false;
+    }
+    if (largo > escritor->tam){
+        return escritor->escribir(bytes, largo, escritor->extra);
+    }
+    if (largo > 0){
+        memcpy(escritor->buffer + escritor->usados, bytes, largo);
+    }
+    escritor->usados += largo;
+    return true;
+}
+
+bool escritor_agregar_largo(escritor_t *escritor, size_t largo){
+    uint64_t largo64 = largo;
+    return escritor_agregar(escritor, &largo64, sizeof(largo64));
+}
+
+/***************************
+* Funciones auxiliares del Lector
+****************************/
+
+/* Suma largo a los bytes que se sabe que le quedan al flujo. */
+void lector_anunciar(lector_t *lector, size_t largo){
+    lector->conocidos = largo < SIZE_MAX - lector->conocidos ? lector->conocidos + largo : SIZE_MAX;
+}
+
+/* Deja en destino los siguientes largo bytes del flujo. Devuelve false si el
+flujo terminó antes.
+Pre: los largo bytes ya se anunciaron con lector_anunciar. */
+bool lector_leer(lector_t *lector, void *destino, size_t largo){
+    char *salida = destino;
+    while (largo > 0){
+        if (lector->inicio == lector->fin){
+            if (lector->conocidos < largo){
+                return false;
+            }
+            // Lo que falta no entra en el buffer: se lee directo en destino.
+            if (largo >= lector->tam){
+                lector->conocidos -= largo;
+                return lector->leer(salida, largo, lector->extra) == largo;
+            }
+            size_t pedidos = lector->conocidos < lector->tam ? lector->conocidos : lector->tam;
+            lector->inicio = 0;
+            lector->fin = lector->leer(lector->buffer, pedidos, lector->extra);
+            lector->conocidos -= lector->fin;
+            if (lector->fin == 0){
+                return false;
+            }
+        }
+        size_t disponibles = lector->fin - lector->inicio;
+        size_t copiar = largo < disponibles ? largo : disponibles;
+        memcpy(salida, lector->buffer + lector->inicio, copiar);
+        lector->inicio += copiar;
+        salida += copiar;
+        largo -= copiar;
+    }
+    return true;
+}
+
+bool lector_leer_largo(lector_t *lector, size_t *largo){
+    uint64_t largo64;
+    if (!lector_leer(lector, &largo64, sizeof(largo64)) || largo64 > SIZE_MAX){
+        return false;
+    }
+    *largo = (size_t) largo64;
+    return true;
+}
+
+/* Se asegura de que *registro tenga lugar para largo bytes. */
+bool lector_agrandar_registro(char **registro, size_t *tam, size_t largo){
+    if (largo <= *tam){
+        return true;
+    }
+    char *nuevo = realloc(*registro, largo);
+    if (!nuevo){
+        return false;
+    }
+    *registro = nuevo;
+    *tam = largo;
+    return true;
+}
+
+/* Deja en *registro los siguientes largo bytes del flujo, agrandándolo a medida
+que los bytes llegan: un largo falso, que anuncia más de lo que el flujo trae,
+no pide de una vez más memoria que el doble de lo que efectivamente se leyó.
+Devuelve false si el flujo terminó antes o si no hubo memoria.
+Pre: los largo bytes ya se anunciaron con lector_anunciar. */
+bool lector_leer_registro(lector_t *lector, char **registro, size_t *tam, size_t largo){
+    size_t leidos = 0;
+    while (leidos < largo){
+        size_t paso = leidos > lector->tam ? leidos : lector->tam;
+        if (paso > largo - leidos) paso = largo - leidos;
+        if (!lector_agrandar_registro(registro, tam, leidos + paso) ||
+            !lector_leer(lector, *registro + leidos, paso)){
+            return false;
+        }
+        leidos += paso;
+    }
+    return true;
+}
+
+/***************************
+* Funciones auxiliares de descriptores
+****************************/
+
+bool escribir_en_fd(const void *bytes, size_t largo, void *extra){
+    int fd = *(int *) extra;
+    const char *resto = bytes;
+    while (largo > 0){
+        ssize_t escritos = write(fd, resto, largo);
+        if (escritos < 0){
+            if (errno == EINTR) continue;
+            return false;
+        }
+        resto += escritos;
+        largo -= (size_t) escritos;
+    }
+    return true;
+}
+
+size_t leer_de_fd(void *destino, size_t largo, void *extra){
+    int fd = *(int *) extra;
+    char *salida = destino;
+    size_t total = 0;
+    while (total < largo){
+        ssize_t leidos = read(fd, salida + total, largo - total);
+        if (leidos < 0){
+            if (errno == EINTR) continue;
+            break;
+        }
+        if (leidos == 0){
+            break;
+        }
+        total += (size_t) leidos;
+    }
+    return total;
+}
+
+/***************************
+* Primitivas del Flujo
+****************************/
+
+bool hash_escribir_flujo(const hash_t *hash, hash_dato_a_bytes_t dato_a_bytes,
+                         hash_flujo_escribir_t escribir, void *extra, size_t tam_buffer){
+    escritor_t escritor = {malloc(tam_buffer), tam_buffer, 0, escribir, extra};
+    if (!escritor.buffer){
+        return false;
+    }
+
+    bool ok = escritor_agregar(&escritor, FLUJO_MAGIA, LARGO_MAGIA) &&
+              escritor_agregar_largo(&escritor, hash_cantidad(hash));
+
+    hash_iter_t iter;
+    hash_iter_iniciar(&iter, hash);
+    while (ok && !hash_iter_al_final(&iter)){
+        size_t largo_clave;
+        const void *clave = hash_iter_ver_actual_n(&iter, &largo_clave);
+        void *dato = hash_iter_ver_valor(&iter);
+
+        const void *bytes = &dato;
+        size_t largo_dato = sizeof(dato);
+        if (dato_a_bytes){
+            bytes = NULL;
+            largo_dato = dato_a_bytes(dato, &bytes);
+            if (!bytes) largo_dato = 0;
+        }
+
+        ok = escritor_agregar_largo(&escritor, largo_clave) &&
+             escritor_agregar_largo(&escritor, largo_dato) &&
+             escritor_agregar(&escritor, clave, largo_clave) &&
+             escritor_agregar(&escritor, bytes, largo_dato);
+        hash_iter_avanzar(&iter);
+    }
+
+    ok = ok && escritor_vaciar(&escritor);
+    free(escritor.buffer);
+    return ok;
+}
+
+bool hash_leer_flujo(hash_t *hash, hash_bytes_a_dato_t bytes_a_dato,
+                     hash_flujo_leer_t leer, void *extra, size_t tam_buffer){
+    lector_t lector = {malloc(tam_buffer), tam_buffer, 0, 0, LARGO_MAGIA + sizeof(uint64_t), leer, extra};
+    if (!lector.buffer){
+        return false;
+    }
+
+    char magia[LARGO_MAGIA];
+    size_t cantidad;
+    bool ok = lector_leer(&lector, magia, LARGO_MAGIA) &&
+              memcmp(magia, FLUJO_MAGIA, LARGO_MAGIA) == 0 &&
+              lector_leer_largo(&lector, &cantidad);
+    if (ok && cantidad > 0) lector_anunciar(&lector, 2 * sizeof(uint64_t));
+
+    // Reservar es sólo para no redimensionar mientras se lee: si no hay
+    // memoria para todo de una vez, se sigue de a un par. La cantidad viene
+    // del flujo, así que no se reserva de una vez más de RESERVA_FLUJO pares:
+    // la reserva se duplica a medida que los pares efectivamente llegan.
+    size_t iniciales = hash_cantidad(hash);
+    size_t reservados = 0;
+
+    char *registro = NULL;
+    size_t tam_registro = 0;
+    for (size_t i = 0; ok && i < cantidad; i++){
+        if (i == reservados){
+            reservados = i < RESERVA_FLUJO ? RESERVA_FLUJO : i;
+            reservados = reservados < cantidad - i ? i + reservados : cantidad;
+            if (reservados <= SIZE_MAX - iniciales) hash_reservar(hash, iniciales + reservados);
+        }
+
+        size_t largo_clave, largo_dato;
+        ok = lector_leer_largo(&lector, &largo_clave) &&
+             lector_leer_largo(&lector, &largo_dato) &&
+             largo_dato < SIZE_MAX - largo_clave;
+        if (ok){
+            lector_anunciar(&lector, largo_clave + largo_dato);
+            if (i + 1 < cantidad) lector_anunciar(&lector, 2 * sizeof(uint64_t));
+        }
+        ok = ok && lector_agrandar_registro(&registro, &tam_registro, 1) &&
+             lector_leer_registro(&lector, &registro, &tam_registro, largo_clave + largo_dato);
+        if (!ok) break;
+
+        void *dato = NULL;
+        const char *bytes = registro + largo_clave;
+        if (bytes_a_dato){
+            ok = bytes_a_dato(bytes, largo_dato, &dato);
+            // Si no se pudo guardar, el dato armado no es de nadie más.
+            if (ok && !hash_guardar_n(hash, registro, largo_clave, dato)){
+                hash_liberar_dato(hash, dato);
+                ok = false;
+            }
+        } else {
+            ok = largo_dato == sizeof(dato);
+            if (ok) memcpy(&dato, bytes, sizeof(dato));
+            ok = ok && hash_guardar_n(hash, registro, largo_clave, dato);
+        }
+    }
+
+    free(registro);
+    free(lector.buffer);
+    return ok;
+}
+
+bool hash_escribir_fd(const hash_t *hash, hash_dato_a_bytes_t dato_a_bytes, int fd){
+    return hash_escribir_flujo(hash, dato_a_bytes, escribir_en_fd, &fd, TAM_BUFFER_FD);
+}
+
+bool hash_leer_fd(hash_t *hash, hash_bytes_a_dato_t bytes_a_dato, int fd){
+    return hash_leer_flujo(hash, bytes_a_dato, leer_de_fd, &fd, TAM_BUFFER_FD);
+}
@@ -0,0 +1,59 @@
+#ifndef HASH_FLUJO_H
+#define HASH_FLUJO_H
+
+#include "hash.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/* Escritura y lectura de un hash como un flujo de registros: un encabezado con
+ * la cantidad de pares y, por cada par, el largo de la clave, el largo del
+ * dato, la clave y los bytes del dato. Los pares se emiten en el orden del
+ * iterador del hash y se pasan de a bloques por un buffer de tamaño fijo, por
+ * lo que escribir o leer un hash no necesita tener en memoria una copia de
+ * todo el hash. Los largos se guardan en el orden de bytes de la máquina. */
+
+// tipo de función que recibe un bloque de bytes del flujo; devuelve false si
+// no pudo hacer nada con ellos
+typedef bool (*hash_flujo_escribir_t)(const void *bytes, size_t largo, void *extra);
+
+// tipo de función que deja en destino los siguientes bytes del flujo, hasta
+// largo; devuelve cuántos dejó (menos de largo sólo al terminar el flujo)
+typedef size_t (*hash_flujo_leer_t)(void *destino, size_t largo, void *extra);
+
+// tipo de función que arma un dato a partir de los bytes leídos de un flujo y
+// lo deja en *dato; devuelve false si no pudo armarlo
+typedef bool (*hash_bytes_a_dato_t)(const void *bytes, size_t largo, void **dato);
+
+/* Emite el hash como flujo de registros, llamando a escribir con bloques de
+ * a lo sumo tam_buffer bytes (salvo los pares que no entran en el buffer, que
+ * se pasan enteros). Los bytes de cada dato son los que devuelve
+ * dato_a_bytes; si es NULL se escribe el valor de cada puntero, como en
+ * hash_serializar. Devuelve false si escribir devolvió false o no hubo
+ * memoria para el buffer.
+ * Pre: La estructura hash fue inicializada y no se la modifica mientras tanto.
+ * tam_buffer es mayor a 0.
+ */
+bool hash_escribir_flujo(const hash_t *hash, hash_dato_a_bytes_t dato_a_bytes,
+                         hash_flujo_escribir_t escribir, void *extra, size_t tam_buffer);
+
+/* Guarda en el hash los pares de un flujo emitido por hash_escribir_flujo,
+ * pidiéndole los bytes a leer de a bloques de tam_buffer. Cada dato se arma
+ * con bytes_a_dato; si es NULL, los bytes son el valor del puntero. Las
+ * claves que ya estaban se reemplazan, igual que con hash_guardar. Devuelve
+ * false si el flujo no es válido o está incompleto, o si no hubo memoria; en
+ * ese caso los pares leídos hasta el error quedan guardados. Nunca se le piden
+ * a leer bytes posteriores al flujo, así que se pueden leer varios flujos
+ * escritos uno detrás de otro, o un flujo de un pipe que sigue abierto.
+ * Pre: La estructura hash fue inicializada. tam_buffer es mayor a 0.
+ */
+bool hash_leer_flujo(hash_t *hash, hash_bytes_a_dato_t bytes_a_dato,
+                     hash_flujo_leer_t leer, void *extra, size_t tam_buffer);
+
+/* Igual que hash_escribir_flujo y hash_leer_flujo, pero escribiendo en o
+ * leyendo de un descriptor de archivo (un archivo, un pipe o un socket).
+ */
+bool hash_escribir_fd(const hash_t *hash, hash_dato_a_bytes_t dato_a_bytes, int fd);
+bool hash_leer_fd(hash_t *hash, hash_bytes_a_dato_t bytes_a_dato, int fd);
+
+#endif // HASH_FLUJO_H
@@ -0,0 +1,292 @@
+/*
+ * hash_flujo_pruebas.c
+ * Pruebas para la escritura y lectura del hash como flujo
+ */
+
+#include "hash_flujo.h"
+#include "testing.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define LARGO_CLAVE 48
+#define LARGO_DATO_GRANDE 1000
+#define TAM_BUFFER_CHICO 16
+
+/* ******************************************************************
+ *                        PRUEBAS UNITARIAS
+ * *****************************************************************/
+
+/* Flujo en memoria: escribir agrega al final, leer consume desde posicion. */
+typedef struct memoria {
+    char *datos;
+    size_t largo;
+    size_t capacidad;
+    size_t posicion;
+    size_t bloque_maximo;
+} memoria_t;
+
+static bool escribir_en_memoria(const void *bytes, size_t largo, void *extra)
+{
+    memoria_t *memoria = extra;
+    if (largo > memoria->bloque_maximo) memoria->bloque_maximo = largo;
+    if (memoria->largo + largo > memoria->capacidad) {
+        size_t capacidad = (memoria->largo + largo) * 2;
+        char *datos = realloc(memoria->datos, capacidad);
+        if (!datos) return false;
+        memoria->datos = datos;
+        memoria->capacidad = capacidad;
+    }
+    memcpy(memoria->datos + memoria->largo, bytes, largo);
+    memoria->largo += largo;
+    return true;
+}
+
+static size_t leer_de_memoria(void *destino, size_t largo, void *extra)
+{
+    memoria_t *memoria = extra;
+    size_t quedan = memoria->largo - memoria->posicion;
+    if (largo > quedan) largo = quedan;
+    memcpy(destino, memoria->datos + memoria->posicion, largo);
+    memoria->posicion += largo;
+    return largo;
+}
+
+/* Los datos son cadenas: se escriben con su '\0' y se leen con una copia. */
+static size_t cadena_a_bytes(const void *dato, const void **bytes)
+{
+    *bytes = dato;
+    return strlen(dato) + 1;
+}
+
+static bool bytes_a_cadena(const void *bytes, size_t largo, void **dato)
+{
+    char *cadena = malloc(largo);
+    if (!cadena) return false;
+    memcpy(cadena, bytes, largo);
+    *dato = cadena;
+    return true;
+}
+
+/* Deja en dato una cadena distinta para cada i; cada tanto, una más larga que
+ * el buffer del flujo. */
+static char *crear_dato(size_t i)
+{
+    size_t largo = i % 50 ? 16 : LARGO_DATO_GRANDE;
+    char *dato = malloc(largo);
+    if (!dato) return NULL;
+    memset(dato, 'a' + (int) (i % 26), largo - 1);
+    snprintf(dato, largo, "%zu", i);
+    dato[strlen(dato)] = '-';
+    dato[largo - 1] = '\0';
+    return dato;
+}
+
+static bool mismos_pares(const hash_t *original, const hash_t *copia)
+{
+    if (hash_cantidad(original) != hash_cantidad(copia)) return false;
+
+    hash_iter_t iter;
+    hash_iter_iniciar(&iter, original);
+    for (; !hash_iter_al_final(&iter); hash_iter_avanzar(&iter)) {
+        size_t largo;
+        const void *clave = hash_iter_ver_actual_n(&iter, &largo);
+        const char *dato = hash_obtener_n(copia, clave, largo);
+        if (!dato || strcmp(dato, hash_iter_ver_valor(&iter)) != 0) return false;
+    }
+    return true;
+}
+
+static hash_t *crear_hash_prueba(size_t largo)
+{
+    hash_t *hash = hash_crear(free);
+    char clave[LARGO_CLAVE];
+
+    for (size_t i = 0; hash && i < largo; i++) {
+        sprintf(clave, i % 10 ? "%08zu" : "clave larga del flujo numero %08zu", i);
+        hash_guardar(hash, clave, crear_dato(i));
+    }
+    // Una clave con bytes nulos, que sólo se puede guardar con su largo.
+    if (hash) hash_guardar_n(hash, "a\0b", 3, crear_dato(largo));
+    return hash;
+}
+
+static void prueba_flujo_memoria(size_t largo)
+{
+    hash_t *hash = crear_hash_prueba(largo);
+    memoria_t memoria = {NULL, 0, 0, 0, 0};
+
+    bool ok = hash_escribir_flujo(hash, cadena_a_bytes, escribir_en_memoria, &memoria, TAM_BUFFER_CHICO);
+    print_test("Prueba flujo escribir con buffer chico devuelve true", ok);
+    print_test("Prueba flujo sólo los datos grandes pasan el buffer", memoria.bloque_maximo == LARGO_DATO_GRANDE);
+
+    hash_t *copia = hash_crear(free);
+    ok = hash_leer_flujo(copia, bytes_a_cadena, leer_de_memoria, &memoria, TAM_BUFFER_CHICO);
+    print_test("Prueba flujo leer con buffer chico devuelve true", ok);
+    print_test("Prueba flujo se leyó todo el flujo", memoria.posicion == memoria.largo);
+    print_test("Prueba flujo la copia tiene los mismos pares", mismos_pares(hash, copia));
+    print_test("Prueba flujo la copia tiene la clave con bytes nulos", hash_pertenece_n(copia, "a\0b", 3));
+
+    // Leer otra vez reemplaza los datos que ya estaban.
+    memoria.posicion = 0;
+    ok = hash_leer_flujo(copia, bytes_a_cadena, leer_de_memoria, &memoria, 4096);
+    print_test("Prueba flujo leer sobre un hash con las mismas claves", ok && mismos_pares(hash, copia));
+
+    hash_destruir(copia);
+    hash_destruir(hash);
+    free(memoria.datos);
+}
+
+static void prueba_flujo_punteros(void)
+{
+    hash_t *hash = hash_crear(NULL);
+    char clave[LARGO_CLAVE];
+    for (size_t i = 0; i < 100; i++) {
+        sprintf(clave, "%zu", i);
+        hash_guardar(hash, clave, (void *) (uintptr_t) (i * 3));
+    }
+
+    memoria_t memoria = {NULL, 0, 0, 0, 0};
+    bool ok = hash_escribir_flujo(hash, NULL, escribir_en_memoria, &memoria, 64);
+    hash_t *copia = hash_crear(NULL);
+    ok = ok && hash_leer_flujo(copia, NULL, leer_de_memoria, &memoria, 64);
+    for (size_t i = 0; i < 100 && ok; i++) {
+        sprintf(clave, "%zu", i);
+        ok = hash_pertenece(copia, clave) && hash_obtener(copia, clave) == (void *) (uintptr_t) (i * 3);
+    }
+    print_test("Prueba flujo sin funciones copia los punteros", ok && hash_cantidad(copia) == 100);
+
+    hash_destruir(copia);
+    hash_destruir(hash);
+    free(memoria.datos);
+}
+
+static void prueba_flujo_invalido(size_t largo)
+{
+    hash_t *hash = crear_hash_prueba(largo);
+    memoria_t memoria = {NULL, 0, 0, 0, 0};
+    hash_escribir_flujo(hash, cadena_a_bytes, escribir_en_memoria, &memoria, 256);
+    size_t largo_total = memoria.largo;
+
+    // Flujo cortado en el medio de un registro.
+    memoria.largo = largo_total / 2;
+    hash_t *copia = hash_crear(free);
+    bool ok = hash_leer_flujo(copia, bytes_a_cadena, leer_de_memoria, &memoria, 256);
+    print_test("Prueba flujo incompleto devuelve false", !ok);
+    print_test("Prueba flujo incompleto guarda los pares anteriores",
+               hash_cantidad(copia) > 0 && hash_cantidad(copia) < hash_cantidad(hash));
+    hash_destruir(copia);
+
+    // Flujo que anuncia muchos más pares de los que tiene: no se reserva
+    // lugar para todos de antemano.
+    uint64_t anunciados = (uint64_t) 1 << 24;
+    memcpy(memoria.datos + 8, &anunciados, sizeof(anunciados));
+    memoria.largo = largo_total;
+    memoria.posicion = 0;
+    copia = hash_crear(free);
+    ok = hash_leer_flujo(copia, bytes_a_cadena, leer_de_memoria, &memoria, 256);
+    hash_estadisticas_t estadisticas;
+    hash_estadisticas(copia, &estadisticas);
+    print_test("Prueba flujo con cantidad falsa devuelve false", !ok && hash_cantidad(copia) == hash_cantidad(hash));
+    print_test("Prueba flujo con cantidad falsa no reserva de más", estadisticas.capacidad < anunciados);
+    hash_destruir(copia);
+
+    // Registro con un largo de dato falso: se lee hasta que el flujo se corta,
+    // sin pedir de una vez la memoria que anuncia.
+    uint64_t largo_falso = (uint64_t) 1 << 50;
+    memcpy(memoria.datos + 24, &largo_falso, sizeof(largo_falso));
+    memoria.posicion = 0;
+    copia = hash_crear(free);
+    ok = hash_leer_flujo(copia, bytes_a_cadena, leer_de_memoria, &memoria, 256);
+    print_test("Prueba flujo con un largo falso devuelve false", !ok && hash_cantidad(copia) == 0);
+    hash_destruir(copia);
+
+    // Largos cuya suma desborda.
+    largo_falso = UINT64_MAX - 4;
+    memcpy(memoria.datos + 16, &largo_falso, sizeof(largo_falso));
+    memoria.posicion = 0;
+    copia = hash_crear(free);
+    ok = hash_leer_flujo(copia, bytes_a_cadena, leer_de_memoria, &memoria, 256);
+    print_test("Prueba flujo con largos que desbordan devuelve false", !ok && hash_cantidad(copia) == 0);
+    hash_destruir(copia);
+
+    // Flujo que no empieza con la marca.
+    memoria.largo = largo_total;
+    memoria.posicion = 0;
+    memoria.datos[0] ^= 1;
+    copia = hash_crear(free);
+    ok = hash_leer_flujo(copia, bytes_a_cadena, leer_de_memoria, &memoria, 256);
+    print_test("Prueba flujo con otra marca devuelve false", !ok && hash_cantidad(copia) == 0);
+    hash_destruir(copia);
+
+    // Flujo vacío.
+    memoria.largo = 0;
+    memoria.posicion = 0;
+    copia = hash_crear(free);
+    print_test("Prueba flujo vacío devuelve false", !hash_leer_flujo(copia, bytes_a_cadena, leer_de_memoria, &memoria, 256));
+    hash_destruir(copia);
+
+    hash_destruir(hash);
+    free(memoria.datos);
+}
+
+static void prueba_flujo_fd(size_t largo)
+{
+    hash_t *hash = crear_hash_prueba(largo);
+    FILE *archivo = tmpfile();
+    print_test("Prueba flujo fd se creó el archivo", archivo);
+    if (!archivo) {
+        hash_destruir(hash);
+        return;
+    }
+
+    int fd = fileno(archivo);
+    print_test("Prueba flujo fd escribir devuelve true", hash_escribir_fd(hash, cadena_a_bytes, fd));
+    lseek(fd, 0, SEEK_SET);
+
+    hash_t *copia = hash_crear(free);
+    print_test("Prueba flujo fd leer devuelve true", hash_leer_fd(copia, bytes_a_cadena, fd));
+    print_test("Prueba flujo fd la copia tiene los mismos pares", mismos_pares(hash, copia));
+
+    // Hash vacío: el flujo es sólo el encabezado.
+    hash_t *vacio = hash_crear(free);
+    lseek(fd, 0, SEEK_SET);
+    print_test("Prueba flujo fd escribir hash vacío", hash_escribir_fd(vacio, cadena_a_bytes, fd));
+    lseek(fd, 0, SEEK_SET);
+    print_test("Prueba flujo fd leer hash vacío", hash_leer_fd(vacio, bytes_a_cadena, fd) && hash_cantidad(vacio) == 0);
+
+    // Dos flujos seguidos en el mismo archivo: cada lectura consume sólo el suyo.
+    hash_t *chico = crear_hash_prueba(largo / 10);
+    lseek(fd, 0, SEEK_SET);
+    bool ok = hash_escribir_fd(hash, cadena_a_bytes, fd) && hash_escribir_fd(chico, cadena_a_bytes, fd);
+    lseek(fd, 0, SEEK_SET);
+    hash_t *primera = hash_crear(free);
+    hash_t *segunda = hash_crear(free);
+    ok = ok && hash_leer_fd(primera, bytes_a_cadena, fd);
+    print_test("Prueba flujo fd leer el primero de dos flujos", ok && mismos_pares(hash, primera));
+    ok = ok && hash_leer_fd(segunda, bytes_a_cadena, fd);
+    print_test("Prueba flujo fd leer el segundo de dos flujos", ok && mismos_pares(chico, segunda));
+    hash_destruir(segunda);
+    hash_destruir(primera);
+    hash_destruir(chico);
+
+    hash_destruir(vacio);
+    hash_destruir(copia);
+    hash_destruir(hash);
+    fclose(archivo);
+}
+
+/* ******************************************************************
+ *                        FUNCIÓN PRINCIPAL
+ * *****************************************************************/
+
+void pruebas_hash_flujo()
+{
+    prueba_flujo_memoria(5000);
+    prueba_flujo_punteros();
+    prueba_flujo_invalido(1000);
+    prueba_flujo_fd(5000);
+}
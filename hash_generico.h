@@ -0,0 +1,251 @@
+#ifndef HASH_GENERICO_H
+#define HASH_GENERICO_H
+
+#include "grupo.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Hash especializado para claves y valores de tamaño fijo (enteros, UUIDs,
+ * structs chicos). HASH_DEFINIR genera un tipo de hash y sus primitivas para un
+ * tipo de clave y uno de valor; claves y valores se guardan por copia dentro de
+ * la tabla, así que no se pide memoria por elemento y una búsqueda es un sondeo
+ * sobre los bytes de control seguido de una comparación con funcion_igual.
+ * La tabla tiene el mismo diseño que la de hash.c (grupos de GRUPO_TAM bytes de
+ * control, sondeo triangular, factor de carga máximo de 7/8), pero redimensiona
+ * de una vez en lugar de migrar de a poco.
+ *
+ * Uso:
+ *      HASH_DEFINIR(hash_ids, uint64_t, double, hash_generico_u64, hash_generico_igual_u64)
+ *
+ * define el tipo hash_ids_t y las primitivas
+ *
+ *      hash_ids_t *hash_ids_crear(void);
+ *      bool hash_ids_guardar(hash_ids_t *hash, uint64_t clave, double valor);
+ *      double *hash_ids_obtener(const hash_ids_t *hash, uint64_t clave);
+ *      bool hash_ids_pertenece(const hash_ids_t *hash, uint64_t clave);
+ *      bool hash_ids_borrar(hash_ids_t *hash, uint64_t clave, double *valor);
+ *      bool hash_ids_reservar(hash_ids_t *hash, size_t cantidad);
+ *      size_t hash_ids_cantidad(const hash_ids_t *hash);
+ *      void hash_ids_iterar(hash_ids_t *hash, bool visitar(uint64_t clave, double *valor, void *extra), void *extra);
+ *      void hash_ids_destruir(hash_ids_t *hash);
+ *
+ * con la misma semántica que las de hash.h, salvo que:
+ *  - obtener devuelve un puntero al valor guardado (NULL si la clave no está),
+ *    que sirve hasta la siguiente operación que modifique el hash;
+ *  - borrar devuelve si la clave estaba y, si valor no es NULL, deja ahí el
+ *    valor que tenía;
+ *  - no hay función para destruir los valores: son copias.
+ *
+ * funcion_hash recibe una clave y devuelve un uint64_t con todos sus bits bien
+ * mezclados (se usan tanto los 7 bajos como los altos); funcion_igual recibe dos
+ * claves y devuelve si son iguales. Las primitivas son static inline: se puede
+ * usar HASH_DEFINIR en un header e incluirlo en varios archivos. */
+
+// Función de hash para claves enteras: el finalizador de MurmurHash3, que es una
+// biyección, así que dos claves distintas nunca tienen el mismo hash.
+static inline uint64_t hash_generico_u64(uint64_t clave){
+    clave ^= clave >> 33;
+    clave *= 0xff51afd7ed558ccdULL;
+    clave ^= clave >> 33;
+    clave *= 0xc4ceb9fe1a85ec53ULL;
+    clave ^= clave >> 33;
+    return clave;
+}
+
+static inline bool hash_generico_igual_u64(uint64_t a, uint64_t b){
+    return a == b;
+}
+
+#define HASH_DEFINIR(nombre, tipo_clave, tipo_valor, funcion_hash, funcion_igual)                   \
+                                                                                                    \
+typedef struct nombre##_campo {                                                                     \
+    tipo_clave clave;                                                                               \
+    tipo_valor valor;                                                                               \
+} nombre##_campo_t;                                                                                 \
+                                                                                                    \
+typedef struct nombre {                                                                             \
+    int8_t *control;                                                                                \
+    nombre##_campo_t *campos;                                                                       \
+    size_t capacidad;                                                                               \
+    size_t cantidad;                                                                                \
+    size_t borrados;                                                                                \
+} nombre##_t;                                                                                       \
+                                                                                                    \
+/* Devuelve la posición de la clave, o la capacidad si no está. Si libre no es                      \
+NULL, deja en *libre la primera posición libre de la secuencia de sondeo. */                        \
+static inline size_t nombre##_buscar(const nombre##_t *hash, tipo_clave clave, uint64_t num_hash,   \
+                                     size_t *libre){                                                \
+    size_t mascara = hash->capacidad / GRUPO_TAM - 1;                                               \
+    size_t grupo = (size_t) (num_hash >> 7) & mascara;                                              \
+    int8_t h2 = (int8_t) (num_hash & GRUPO_H2_MASCARA);                                             \
+    if (libre) *libre = hash->capacidad;                                                            \
+                                                                                                    \
+    for (size_t salto = 1; salto <= mascara + 1; salto++){                                          \
+        const int8_t *control = hash->control + grupo * GRUPO_TAM;                                  \
+        uint32_t coincidencias = grupo_coincidencias(control, h2);                                  \
+        while (coincidencias){                                                                      \
+            size_t posicion = grupo * GRUPO_TAM + (size_t) __builtin_ctz(coincidencias);            \
+            if (funcion_igual(hash->campos[posicion].clave, clave)) return posicion;                \
+            coincidencias &= coincidencias - 1;                                                     \
+        }                                                                                           \
+        if (libre && *libre == hash->capacidad){                                                    \
+            uint32_t libres = grupo_libres(control);                                                \
+            if (libres) *libre = grupo * GRUPO_TAM + (size_t) __builtin_ctz(libres);                \
+        }                                                                                           \
+        if (grupo_vacios(control)) break;                                                           \
+        grupo = (grupo + salto) & mascara;                                                          \
+    }                                                                                               \
+    return hash->capacidad;                                                                         \
+}                                                                                                   \
+                                                                                                    \
+/* Guarda el campo en la primera posición libre de su secuencia de sondeo.                          \
+Pre: la clave no está en el hash y hay lugar. */                                                    \
+static inline void nombre##_ubicar(nombre##_t *hash, nombre##_campo_t campo, uint64_t num_hash){    \
+    size_t mascara = hash->capacidad / GRUPO_TAM - 1;                                               \
+    size_t grupo = (size_t) (num_hash >> 7) & mascara;                                              \
+    for (size_t salto = 1; ; salto++){                                                              \
+        uint32_t libres = grupo_libres(hash->control + grupo * GRUPO_TAM);                          \
+        if (libres){                                                                                \
+            size_t posicion = grupo * GRUPO_TAM + (size_t) __builtin_ctz(libres);                   \
+            if (hash->control[posicion] == GRUPO_BORRADO) hash->borrados--;                         \
+            hash->control[posicion] = (int8_t) (num_hash & GRUPO_H2_MASCARA);                       \
+            hash->campos[posicion] = campo;                                                         \
+            hash->cantidad++;                                                                       \
+            return;                                                                                 \
+        }                                                                                           \
+        grupo = (grupo + salto) & mascara;                                                          \
+    }                                                                                               \
+}                                                                                                   \
+                                                                                                    \
+/* Pasa todos los campos a tablas nuevas de la capacidad recibida, que es                           \
+potencia de 2 y alcanza para todos. Devuelve false si no hay memoria. */                            \
+static inline bool nombre##_redimensionar(nombre##_t *hash, size_t capacidad){                      \
+    int8_t *control = malloc(capacidad * sizeof(int8_t));                                           \
+    nombre##_campo_t *campos = malloc(capacidad * sizeof(nombre##_campo_t));                        \
+    if (!control || !campos){                                                                       \
+        free(control);                                                                              \
+        free(campos);                                                                               \
+        return false;                                                                               \
+    }                                                                                               \
+    memset(control, GRUPO_VACIO, capacidad);                                                        \
+                                                                                                    \
+    nombre##_t anterior = *hash;                                                                    \
+    *hash = (nombre##_t){control, campos, capacidad, 0, 0};                                         \
+    for (size_t i = 0; i < anterior.capacidad; i++){                                                \
+        if (anterior.control[i] < 0) continue;                                                      \
+        nombre##_campo_t campo = anterior.campos[i];                                                \
+        nombre##_ubicar(hash, campo, funcion_hash(campo.clave));                                    \
+    }                                                                                               \
+    free(anterior.control);                                                                         \
+    free(anterior.campos);                                                                          \
+    return true;                                                                                    \
+}                                                                                                   \
+                                                                                                    \
+/* Devuelve la menor capacidad en la que entran cantidad elementos, o 0 si                          \
+no es representable. */                                                                             \
+static inline size_t nombre##_capacidad_para(size_t cantidad){                                      \
+    size_t capacidad = GRUPO_TAM;                                                                   \
+    while (cantidad > capacidad / 8 * 7){                                                           \
+        if (capacidad > SIZE_MAX / 2 / sizeof(nombre##_campo_t)) return 0;                          \
+        capacidad *= 2;                                                                             \
+    }                                                                                               \
+    return capacidad;                                                                               \
+}                                                                                                   \
+                                                                                                    \
+static inline nombre##_t *nombre##_crear(void){                                                     \
+    nombre##_t *hash = malloc(sizeof(nombre##_t));                                                  \
+    if (!hash) return NULL;                                                                         \
+    *hash = (nombre##_t){NULL, NULL, 0, 0, 0};                                                      \
+    if (!nombre##_redimensionar(hash, GRUPO_TAM)){                                                  \
+        free(hash);                                                                                 \
+        return NULL;                                                                                \
+    }                                                                                               \
+    return hash;                                                                                    \
+}                                                                                                   \
+                                                                                                    \
+static inline bool nombre##_reservar(nombre##_t *hash, size_t cantidad){                            \
+    if (cantidad < hash->cantidad) cantidad = hash->cantidad;                                       \
+    size_t capacidad = nombre##_capacidad_para(cantidad);                                           \
+    if (capacidad == 0) return false;                                                               \
+    if (capacidad <= hash->capacidad) return true;                                                  \
+    return nombre##_redimensionar(hash, capacidad);                                                 \
+}                                                                                                   \
+                                                                                                    \
+static inline bool nombre##_guardar(nombre##_t *hash, tipo_clave clave, tipo_valor valor){          \
+    uint64_t num_hash = funcion_hash(clave);                                                        \
+    size_t libre;                                                                                   \
+    size_t posicion = nombre##_buscar(hash, clave, num_hash, &libre);                               \
+    if (posicion != hash->capacidad){                                                               \
+        hash->campos[posicion].valor = valor;                                                       \
+        return true;                                                                                \
+    }                                                                                               \
+                                                                                                    \
+    /* Con más de 7/8 de las posiciones ocupadas o borradas se redimensiona: a                      \
+    la misma capacidad si alcanza con sacar los borrados, o al doble. */                            \
+    if ((hash->cantidad + hash->borrados + 1) * 8 > hash->capacidad * 7){                           \
+        size_t capacidad = nombre##_capacidad_para(hash->cantidad + 1);                             \
+        if (capacidad == 0 || !nombre##_redimensionar(hash, capacidad)) return false;               \
+        nombre##_ubicar(hash, (nombre##_campo_t){clave, valor}, num_hash);                          \
+        return true;                                                                                \
+    }                                                                                               \
+    if (hash->control[libre] == GRUPO_BORRADO) hash->borrados--;                                    \
+    hash->control[libre] = (int8_t) (num_hash & GRUPO_H2_MASCARA);                                  \
+    hash->campos[libre] = (nombre##_campo_t){clave, valor};                                         \
+    hash->cantidad++;                                                                               \
+    return true;                                                                                    \
+}                                                                                                   \
+                                                                                                    \
+static inline tipo_valor *nombre##_obtener(const nombre##_t *hash, tipo_clave clave){               \
+    size_t posicion = nombre##_buscar(hash, clave, funcion_hash(clave), NULL);                      \
+    return posicion == hash->capacidad ? NULL : &hash->campos[posicion].valor;                      \
+}                                                                                                   \
+                                                                                                    \
+static inline bool nombre##_pertenece(const nombre##_t *hash, tipo_clave clave){                    \
+    return nombre##_buscar(hash, clave, funcion_hash(clave), NULL) != hash->capacidad;              \
+}                                                                                                   \
+                                                                                                    \
+static inline bool nombre##_borrar(nombre##_t *hash, tipo_clave clave, tipo_valor *valor){          \
+    size_t posicion = nombre##_buscar(hash, clave, funcion_hash(clave), NULL);                      \
+    if (posicion == hash->capacidad) return false;                                                  \
+    if (valor) *valor = hash->campos[posicion].valor;                                               \
+                                                                                                    \
+    /* Igual que en hash.c: si el grupo tiene algún vacío, ninguna búsqueda                         \
+    siguió de largo por él y la posición puede volver a quedar vacía. */                            \
+    if (grupo_vacios(hash->control + (posicion - posicion % GRUPO_TAM))){                           \
+        hash->control[posicion] = GRUPO_VACIO;                                                      \
+    } else {                                                                                        \
+        hash->control[posicion] = GRUPO_BORRADO;                                                    \
+        hash->borrados++;                                                                           \
+    }                                                                                               \
+    hash->cantidad--;                                                                               \
+    return true;                                                                                    \
+}                                                                                                   \
+                                                                                                    \
+static inline size_t nombre##_cantidad(const nombre##_t *hash){                                     \
+    return hash->cantidad;                                                                          \
+}                                                                                                   \
+                                                                                                    \
+static inline void nombre##_iterar(nombre##_t *hash,                                                \
+                                   bool visitar(tipo_clave clave, tipo_valor *valor, void *extra),  \
+                                   void *extra){                                                    \
+    for (size_t i = 0; i < hash->capacidad; i += GRUPO_TAM){                                        \
+        uint32_t ocupadas = grupo_ocupadas(hash->control + i);                                      \
+        while (ocupadas){                                                                           \
+            nombre##_campo_t *campo = &hash->campos[i + (size_t) __builtin_ctz(ocupadas)];          \
+            if (!visitar(campo->clave, &campo->valor, extra)) return;                               \
+            ocupadas &= ocupadas - 1;                                                               \
+        }                                                                                           \
+    }                                                                                               \
+}                                                                                                   \
+                                                                                                    \
+static inline void nombre##_destruir(nombre##_t *hash){                                             \
+    free(hash->control);                                                                            \
+    free(hash->campos);                                                                             \
+    free(hash);                                                                                     \
+}
+
+#endif // HASH_GENERICO_H
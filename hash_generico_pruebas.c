@@ -0,0 +1,176 @@
+/*
+ * hash_generico_pruebas.c
+ * Pruebas para los hashes generados con HASH_DEFINIR
+ */
+
+#include "hash.h"
+#include "hash_generico.h"
+#include "testing.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+/* Claves de 16 bytes, como un UUID. */
+typedef struct uuid {
+    uint8_t bytes[16];
+} uuid_prueba_t;
+
+static inline uint64_t hash_uuid(uuid_prueba_t clave)
+{
+    return hash_funcion_defecto(clave.bytes, sizeof(clave.bytes), 0);
+}
+
+static inline bool igual_uuid(uuid_prueba_t a, uuid_prueba_t b)
+{
+    return memcmp(a.bytes, b.bytes, sizeof(a.bytes)) == 0;
+}
+
+HASH_DEFINIR(hash_enteros, uint64_t, uint64_t, hash_generico_u64, hash_generico_igual_u64)
+HASH_DEFINIR(hash_uuids, uuid_prueba_t, double, hash_uuid, igual_uuid)
+
+/* ******************************************************************
+ *                        PRUEBAS UNITARIAS
+ * *****************************************************************/
+
+static void prueba_generico_basico(void)
+{
+    hash_enteros_t *hash = hash_enteros_crear();
+    print_test("Prueba generico crear", hash);
+    print_test("Prueba generico la cantidad es 0", hash_enteros_cantidad(hash) == 0);
+    print_test("Prueba generico obtener en vacío es NULL", !hash_enteros_obtener(hash, 0));
+    print_test("Prueba generico borrar en vacío es false", !hash_enteros_borrar(hash, 0, NULL));
+
+    print_test("Prueba generico guardar 0", hash_enteros_guardar(hash, 0, 10));
+    print_test("Prueba generico guardar UINT64_MAX", hash_enteros_guardar(hash, UINT64_MAX, 20));
+    print_test("Prueba generico la cantidad es 2", hash_enteros_cantidad(hash) == 2);
+
+    uint64_t *valor = hash_enteros_obtener(hash, 0);
+    print_test("Prueba generico obtener 0", valor && *valor == 10);
+    print_test("Prueba generico pertenece UINT64_MAX", hash_enteros_pertenece(hash, UINT64_MAX));
+    print_test("Prueba generico no pertenece 1", !hash_enteros_pertenece(hash, 1));
+
+    *valor = 11;
+    print_test("Prueba generico modificar a través de obtener", *hash_enteros_obtener(hash, 0) == 11);
+    print_test("Prueba generico reemplazar", hash_enteros_guardar(hash, 0, 12) && *hash_enteros_obtener(hash, 0) == 12);
+    print_test("Prueba generico reemplazar no cambia la cantidad", hash_enteros_cantidad(hash) == 2);
+
+    uint64_t borrado = 0;
+    print_test("Prueba generico borrar UINT64_MAX", hash_enteros_borrar(hash, UINT64_MAX, &borrado) && borrado == 20);
+    print_test("Prueba generico borrar otra vez es false", !hash_enteros_borrar(hash, UINT64_MAX, &borrado));
+    print_test("Prueba generico la cantidad es 1", hash_enteros_cantidad(hash) == 1);
+
+    hash_enteros_destruir(hash);
+}
+
+static bool sumar(uint64_t clave, uint64_t *valor, void *extra)
+{
+    *(uint64_t *) extra += clave + *valor;
+    return true;
+}
+
+static bool contar_hasta_diez(uint64_t clave, uint64_t *valor, void *extra)
+{
+    (void) clave;
+    (void) valor;
+    return ++*(size_t *) extra < 10;
+}
+
+static void prueba_generico_volumen(size_t largo)
+{
+    hash_enteros_t *hash = hash_enteros_crear();
+
+    bool ok = true;
+    for (uint64_t i = 0; i < largo && ok; i++) {
+        ok = hash_enteros_guardar(hash, i * 7919, i);
+    }
+    print_test("Prueba generico volumen guardar todos", ok && hash_enteros_cantidad(hash) == largo);
+
+    for (uint64_t i = 0; i < largo && ok; i++) {
+        uint64_t *valor = hash_enteros_obtener(hash, i * 7919);
+        ok = valor && *valor == i && !hash_enteros_pertenece(hash, i * 7919 + 1);
+    }
+    print_test("Prueba generico volumen obtener todos", ok);
+
+    uint64_t suma = 0, esperada = 0;
+    for (uint64_t i = 0; i < largo; i++) esperada += i * 7919 + i;
+    hash_enteros_iterar(hash, sumar, &suma);
+    print_test("Prueba generico volumen iterar visita todos", suma == esperada);
+
+    size_t visitados = 0;
+    hash_enteros_iterar(hash, contar_hasta_diez, &visitados);
+    print_test("Prueba generico volumen iterar se corta", visitados == 10);
+
+    // Borrar y volver a guardar muchas veces deja marcas de borrado que la tabla
+    // tiene que ir limpiando sin crecer de más.
+    for (size_t vuelta = 0; vuelta < 4 && ok; vuelta++) {
+        for (uint64_t i = 0; i < largo && ok; i += 2) {
+            ok = hash_enteros_borrar(hash, i * 7919, NULL);
+        }
+        for (uint64_t i = 0; i < largo && ok; i += 2) {
+            ok = hash_enteros_guardar(hash, i * 7919, i + vuelta);
+        }
+    }
+    print_test("Prueba generico volumen borrar y guardar", ok && hash_enteros_cantidad(hash) == largo);
+    print_test("Prueba generico volumen la tabla no creció de más", hash->capacidad <= 4 * largo);
+
+    for (uint64_t i = 0; i < largo && ok; i++) {
+        ok = hash_enteros_borrar(hash, i * 7919, NULL);
+    }
+    print_test("Prueba generico volumen borrar todos", ok && hash_enteros_cantidad(hash) == 0);
+
+    hash_enteros_destruir(hash);
+}
+
+static void prueba_generico_reservar(size_t largo)
+{
+    hash_enteros_t *hash = hash_enteros_crear();
+    print_test("Prueba generico reservar", hash_enteros_reservar(hash, largo));
+
+    size_t capacidad = hash->capacidad;
+    bool ok = true;
+    for (uint64_t i = 0; i < largo && ok; i++) {
+        ok = hash_enteros_guardar(hash, i, i);
+    }
+    print_test("Prueba generico reservar no redimensiona al guardar", ok && hash->capacidad == capacidad);
+
+    hash_enteros_destruir(hash);
+}
+
+static void prueba_generico_uuid(size_t largo)
+{
+    hash_uuids_t *hash = hash_uuids_crear();
+    uuid_prueba_t clave;
+    memset(&clave, 0xAB, sizeof(clave));
+
+    bool ok = true;
+    for (size_t i = 0; i < largo && ok; i++) {
+        memcpy(clave.bytes, &i, sizeof(i));
+        ok = hash_uuids_guardar(hash, clave, (double) i / 2);
+    }
+    print_test("Prueba generico uuid guardar todos", ok && hash_uuids_cantidad(hash) == largo);
+
+    for (size_t i = 0; i < largo && ok; i++) {
+        memcpy(clave.bytes, &i, sizeof(i));
+        double *valor = hash_uuids_obtener(hash, clave);
+        ok = valor && *valor == (double) i / 2;
+    }
+    print_test("Prueba generico uuid obtener todos", ok);
+
+    clave.bytes[15] = 0;
+    print_test("Prueba generico uuid con un byte distinto no pertenece", !hash_uuids_pertenece(hash, clave));
+
+    hash_uuids_destruir(hash);
+}
+
+/* ******************************************************************
+ *                        FUNCIÓN PRINCIPAL
+ * *****************************************************************/
+
+void pruebas_hash_generico()
+{
+    prueba_generico_basico();
+    prueba_generico_volumen(50000);
+    prueba_generico_reservar(10000);
+    prueba_generico_uuid(20000);
+}
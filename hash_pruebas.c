@@ -8,6 +8,7 @@
 #include "hash.h"
 #include "testing.h"
 
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -216,7 +217,7 @@ static void prueba_hash_volumen(size_t largo, bool debug)
     const size_t largo_clave = 10;
     char (*claves)[largo_clave] = malloc(largo * largo_clave);
 
-    unsigned* valores[largo];
+    unsigned** valores = malloc(largo * sizeof(unsigned*));
 
     /* Inserta 'largo' parejas en el hash */
     bool ok = true;
@@ -263,12 +264,860 @@ static void prueba_hash_volumen(size_t largo, bool debug)
     }
 
     free(claves);
+    free(valores);
 
     /* Destruye el hash - debería liberar los enteros */
     hash_destruir(hash);
 
 }
 
+static void prueba_hash_fallos_con_borrados(size_t largo)
+{
+    hash_t* hash = hash_crear(NULL);
+    char clave[24];
+
+    /* Inserta 'largo' claves y borra la mitad, dejando posiciones borradas */
+    bool ok = true;
+    for (size_t i = 0; i < largo && ok; i++) {
+        sprintf(clave, "%08zu", i);
+        ok = hash_guardar(hash, clave, NULL);
+    }
+    for (size_t i = 0; i < largo && ok; i += 2) {
+        sprintf(clave, "%08zu", i);
+        ok = hash_pertenece(hash, clave);
+        hash_borrar(hash, clave);
+    }
+    print_test("Prueba hash fallos, insertar y borrar la mitad", ok && hash_cantidad(hash) == largo / 2);
+
+    /* Las claves borradas y las que nunca estuvieron no pertenecen; las otras sí */
+    for (size_t i = 0; i < largo && ok; i++) {
+        sprintf(clave, "%08zu", i);
+        ok = hash_pertenece(hash, clave) == (i % 2 == 1);
+        sprintf(clave, "x%07zu", i);
+        ok = ok && !hash_pertenece(hash, clave) && !hash_obtener(hash, clave);
+    }
+    print_test("Prueba hash fallos, sólo pertenecen las claves no borradas", ok);
+
+    hash_destruir(hash);
+}
+
+static uint64_t funcion_constante(const void *clave, size_t largo, uint64_t semilla)
+{
+    return 42;
+}
+
+static void prueba_hash_funcion_propia(size_t largo)
+{
+    char clave[24];
+    char *otra = "perro";
+
+    /* La función por defecto es determinística para una misma semilla */
+    print_test("Prueba hash funcion defecto, misma semilla mismo hash",
+               hash_funcion_defecto(otra, strlen(otra), 7) == hash_funcion_defecto(otra, strlen(otra), 7));
+    print_test("Prueba hash funcion defecto, otra semilla otro hash",
+               hash_funcion_defecto(otra, strlen(otra), 7) != hash_funcion_defecto(otra, strlen(otra), 8));
+
+    /* Con una función que hace colisionar todas las claves el hash sigue funcionando */
+    hash_t* hash = hash_crear_con_funcion(NULL, funcion_constante, 0);
+    print_test("Prueba hash crear con funcion propia", hash);
+
+    bool ok = true;
+    for (size_t i = 0; i < largo && ok; i++) {
+        sprintf(clave, "%04zu", i);
+        ok = hash_guardar(hash, clave, &largo);
+    }
+    print_test("Prueba hash funcion constante, insertar todas las claves", ok);
+    for (size_t i = 0; i < largo && ok; i++) {
+        sprintf(clave, "%04zu", i);
+        ok = hash_obtener(hash, clave) == &largo;
+    }
+    print_test("Prueba hash funcion constante, obtener todas las claves", ok);
+    print_test("Prueba hash funcion constante, clave ausente no pertenece", !hash_pertenece(hash, otra));
+    for (size_t i = 0; i < largo && ok; i++) {
+        sprintf(clave, "%04zu", i);
+        ok = hash_borrar(hash, clave) == &largo;
+    }
+    print_test("Prueba hash funcion constante, borrar todas las claves", ok && hash_cantidad(hash) == 0);
+    hash_destruir(hash);
+
+    /* djb2 con semilla fija */
+    hash = hash_crear_con_funcion(NULL, hash_funcion_djb2, 5381);
+    print_test("Prueba hash djb2 insertar clave", hash_guardar(hash, otra, otra));
+    print_test("Prueba hash djb2 obtener clave", hash_obtener(hash, otra) == otra);
+    hash_destruir(hash);
+}
+
+static size_t llamados_funcion_contadora;
+
+static uint64_t funcion_contadora(const void *clave, size_t largo, uint64_t semilla)
+{
+    llamados_funcion_contadora++;
+    return hash_funcion_defecto(clave, largo, semilla);
+}
+
+static void prueba_hash_redimensionar_sin_rehashear(size_t largo)
+{
+    hash_t* hash = hash_crear_con_funcion(NULL, funcion_contadora, 1);
+    char clave[24];
+    llamados_funcion_contadora = 0;
+
+    /* Cada inserción calcula un solo hash, aunque el hash crezca varias veces */
+    bool ok = true;
+    for (size_t i = 0; i < largo && ok; i++) {
+        sprintf(clave, "%08zu", i);
+        ok = hash_guardar(hash, clave, NULL);
+    }
+    print_test("Prueba hash redimensionar, insertar muchos elementos", ok);
+    print_test("Prueba hash redimensionar no recalcula los hashes", llamados_funcion_contadora == largo);
+
+    for (size_t i = 0; i < largo && ok; i++) {
+        sprintf(clave, "%08zu", i);
+        ok = hash_pertenece(hash, clave);
+    }
+    print_test("Prueba hash redimensionar, pertenecen todos los elementos", ok);
+
+    hash_destruir(hash);
+}
+
+static void prueba_hash_migracion_incremental(size_t largo)
+{
+    hash_t* hash = hash_crear(NULL);
+    char clave[24];
+
+    /* Tras cada inserción siguen estando la clave nueva y las anteriores,
+     * aunque el hash esté migrando de a poco a una tabla más grande */
+    bool ok = true;
+    for (size_t i = 0; i < largo && ok; i++) {
+        sprintf(clave, "%08zu", i);
+        ok = hash_guardar(hash, clave, NULL) && hash_pertenece(hash, clave);
+        sprintf(clave, "%08zu", i / 2);
+        ok = ok && hash_pertenece(hash, clave);
+    }
+    print_test("Prueba hash migracion, las claves pertenecen durante el crecimiento", ok);
+
+    /* Con 1800 elementos el hash acaba de empezar a migrar de 2048 a 4096
+     * posiciones: el iterador debe recorrer ambas tablas */
+    size_t iterados = 0;
+    hash_iter_t* iter = hash_iter_crear(hash);
+    while (!hash_iter_al_final(iter)) {
+        ok = ok && hash_pertenece(hash, hash_iter_ver_actual(iter));
+        iterados++;
+        hash_iter_avanzar(iter);
+    }
+    hash_iter_destruir(iter);
+    print_test("Prueba hash migracion, el iterador recorre todos los elementos", ok && iterados == largo);
+
+    for (size_t i = 0; i < largo && ok; i++) {
+        sprintf(clave, "%08zu", i);
+        ok = hash_borrar(hash, clave) == NULL && !hash_pertenece(hash, clave);
+    }
+    print_test("Prueba hash migracion, borrar todos los elementos", ok && hash_cantidad(hash) == 0);
+
+    hash_destruir(hash);
+}
+
+static void prueba_hash_arena(size_t largo)
+{
+    hash_t* hash = hash_crear_con_arena(free);
+    print_test("Prueba hash crear hash con arena", hash);
+
+    /* Claves de largos variados, algunas más grandes que la mayor clase de la arena */
+    char *clave = malloc(largo + 16);
+    bool ok = true;
+    for (size_t i = 0; i < largo && ok; i++) {
+        size_t *valor = malloc(sizeof(size_t));
+        *valor = i;
+        memset(clave, 'a' + (char) (i % 26), i);
+        sprintf(clave + i, "%zu", i);
+        ok = hash_guardar(hash, clave, valor);
+    }
+    print_test("Prueba hash arena, insertar claves de distintos largos", ok && hash_cantidad(hash) == largo);
+
+    /* Borra la mitad y las vuelve a insertar, reutilizando los bloques liberados */
+    for (size_t i = 0; i < largo && ok; i += 2) {
+        memset(clave, 'a' + (char) (i % 26), i);
+        sprintf(clave + i, "%zu", i);
+        size_t *valor = hash_borrar(hash, clave);
+        ok = valor && *valor == i && hash_guardar(hash, clave, valor);
+    }
+    print_test("Prueba hash arena, borrar y reinsertar la mitad", ok && hash_cantidad(hash) == largo);
+
+    for (size_t i = 0; i < largo && ok; i++) {
+        memset(clave, 'a' + (char) (i % 26), i);
+        sprintf(clave + i, "%zu", i);
+        size_t *valor = hash_obtener(hash, clave);
+        ok = valor && *valor == i;
+    }
+    print_test("Prueba hash arena, obtener todas las claves", ok);
+
+    free(clave);
+    hash_destruir(hash);
+}
+
+static void prueba_hash_claves_prefijo()
+{
+    hash_t* hash = hash_crear(NULL);
+    char clave[41] = "";
+    size_t largos[41];
+
+    /* Claves "", "x", "xx"... de hasta 40 bytes: cada una es prefijo de la siguiente,
+     * y algunas entran dentro del campo mientras que otras se guardan aparte */
+    bool ok = true;
+    for (size_t i = 0; i <= 40 && ok; i++) {
+        largos[i] = i;
+        clave[i] = '\0';
+        ok = hash_guardar(hash, clave, &largos[i]);
+        clave[i] = 'x';
+    }
+    print_test("Prueba hash claves prefijo, insertar", ok && hash_cantidad(hash) == 41);
+
+    for (size_t i = 0; i <= 40 && ok; i++) {
+        clave[i] = '\0';
+        ok = hash_obtener(hash, clave) == &largos[i];
+        clave[i] = 'x';
+    }
+    print_test("Prueba hash claves prefijo, obtener cada una", ok);
+
+    /* El iterador devuelve cada clave con su largo */
+    hash_iter_t* iter = hash_iter_crear(hash);
+    while (ok && !hash_iter_al_final(iter)) {
+        const char *actual = hash_iter_ver_actual(iter);
+        size_t *largo = hash_obtener(hash, actual);
+        ok = largo && strlen(actual) == *largo;
+        hash_iter_avanzar(iter);
+    }
+    hash_iter_destruir(iter);
+    print_test("Prueba hash claves prefijo, iterar", ok);
+
+    hash_destruir(hash);
+}
+
+static void prueba_hash_claves_binarias()
+{
+    hash_t* hash = hash_crear(NULL);
+
+    const unsigned char id1[] = {0x00, 0x01, 0x02, 0x03};
+    const unsigned char id2[] = {0x00, 0x01, 0x02, 0x04};
+    char *buffer = "GET /perro HTTP/1.1";
+    char *valor1 = "uno", *valor2 = "dos", *valor3 = "tres";
+
+    /* Claves con bytes en 0 que sólo difieren después del primer '\0' */
+    print_test("Prueba hash guardar_n clave binaria 1", hash_guardar_n(hash, id1, sizeof(id1), valor1));
+    print_test("Prueba hash guardar_n clave binaria 2", hash_guardar_n(hash, id2, sizeof(id2), valor2));
+    print_test("Prueba hash la cantidad de elementos es 2", hash_cantidad(hash) == 2);
+    print_test("Prueba hash obtener_n clave binaria 1", hash_obtener_n(hash, id1, sizeof(id1)) == valor1);
+    print_test("Prueba hash obtener_n clave binaria 2", hash_obtener_n(hash, id2, sizeof(id2)) == valor2);
+    print_test("Prueba hash pertenece_n prefijo de clave binaria, es false", !hash_pertenece_n(hash, id1, 3));
+
+    /* Una porción de un buffer sin '\0' equivale a la misma clave terminada en '\0' */
+    print_test("Prueba hash guardar_n porcion de buffer", hash_guardar_n(hash, buffer + 5, 5, valor3));
+    print_test("Prueba hash obtener clave equivalente a la porcion", hash_obtener(hash, "perro") == valor3);
+
+    /* El iterador devuelve el largo de cada clave */
+    bool ok = true;
+    hash_iter_t* iter = hash_iter_crear(hash);
+    while (!hash_iter_al_final(iter)) {
+        size_t largo;
+        const void *clave = hash_iter_ver_actual_n(iter, &largo);
+        ok = ok && hash_obtener_n(hash, clave, largo) != NULL;
+        hash_iter_avanzar(iter);
+    }
+    hash_iter_destruir(iter);
+    print_test("Prueba hash iter ver_actual_n devuelve claves y largos validos", ok);
+
+    print_test("Prueba hash borrar_n clave binaria 1", hash_borrar_n(hash, id1, sizeof(id1)) == valor1);
+    print_test("Prueba hash pertenece_n clave binaria 2, es true", hash_pertenece_n(hash, id2, sizeof(id2)));
+    print_test("Prueba hash la cantidad de elementos es 2", hash_cantidad(hash) == 2);
+
+    hash_destruir(hash);
+}
+
+static void prueba_hash_obtener_lote(size_t largo)
+{
+    hash_t* hash = hash_crear(NULL);
+    char (*claves)[24] = malloc(largo * 24);
+    const char **lote = malloc(largo * sizeof(char *));
+    void **datos = malloc(largo * sizeof(void *));
+
+    /* Guarda sólo las claves pares; el lote pide todas */
+    bool ok = true;
+    for (size_t i = 0; i < largo; i++) {
+        sprintf(claves[i], "%08zu", i);
+        lote[i] = claves[i];
+        if (i % 2 == 0) ok = ok && hash_guardar(hash, claves[i], claves[i]);
+    }
+    lote[largo - 1] = NULL;
+    print_test("Prueba hash lote, insertar las claves pares", ok);
+
+    hash_obtener_lote(hash, lote, largo, datos);
+    for (size_t i = 0; i < largo - 1 && ok; i++) {
+        ok = datos[i] == (i % 2 == 0 ? claves[i] : NULL);
+    }
+    print_test("Prueba hash lote, obtiene las presentes y NULL las ausentes", ok);
+    print_test("Prueba hash lote, clave NULL devuelve NULL", datos[largo - 1] == NULL);
+
+    free(datos);
+    free(lote);
+    free(claves);
+    hash_destruir(hash);
+}
+
+static void prueba_hash_guardar_lote(size_t largo)
+{
+    hash_t* hash = hash_crear(free);
+    char (*claves)[24] = malloc(largo * 24);
+    const char **lote = malloc(largo * sizeof(char *));
+    void **datos = malloc(largo * sizeof(void *));
+
+    for (size_t i = 0; i < largo; i++) {
+        sprintf(claves[i], "%08zu", i);
+        lote[i] = claves[i];
+        datos[i] = malloc(sizeof(size_t));
+        *(size_t *) datos[i] = i;
+    }
+
+    print_test("Prueba hash reservar lugar", hash_reservar(hash, largo));
+    print_test("Prueba hash guardar lote con claves unicas", hash_guardar_lote(hash, lote, datos, largo / 2, true));
+    print_test("Prueba hash la cantidad de elementos es la mitad", hash_cantidad(hash) == largo / 2);
+
+    /* El segundo lote repite la primera clave, que debe reemplazarse (y liberarse) */
+    void *repetido = malloc(sizeof(size_t));
+    *(size_t *) repetido = 0;
+    lote[largo / 2 - 1] = claves[0];
+    datos[largo / 2 - 1] = repetido;
+    print_test("Prueba hash guardar lote con claves repetidas",
+               hash_guardar_lote(hash, lote + largo / 2 - 1, datos + largo / 2 - 1, largo - largo / 2 + 1, false));
+    print_test("Prueba hash la cantidad de elementos es correcta", hash_cantidad(hash) == largo);
+    print_test("Prueba hash guardar lote reemplaza la clave repetida", hash_obtener(hash, claves[0]) == repetido);
+
+    bool ok = true;
+    for (size_t i = 1; i < largo && ok; i++) {
+        size_t *valor = hash_obtener(hash, claves[i]);
+        ok = valor && *valor == i;
+    }
+    print_test("Prueba hash guardar lote, obtener todos los elementos", ok);
+
+    free(datos);
+    free(lote);
+    free(claves);
+    hash_destruir(hash);
+}
+
+static void prueba_hash_reducir(size_t largo)
+{
+    hash_t* hash = hash_crear(free);
+    char clave[24];
+
+    for (size_t i = 0; i < largo; i++) {
+        size_t *valor = malloc(sizeof(size_t));
+        *valor = i;
+        sprintf(clave, "%08zu", i);
+        hash_guardar(hash, clave, valor);
+    }
+    hash_estadisticas_t estadisticas;
+    hash_estadisticas(hash, &estadisticas);
+    size_t capacidad_llena = estadisticas.capacidad;
+
+    /* Borra 9 de cada 10 claves: el hash se achica varias veces mientras tanto */
+    bool ok = true;
+    for (size_t i = 0; i < largo; i++) {
+        if (i % 10 == 0) continue;
+        sprintf(clave, "%08zu", i);
+        size_t *valor = hash_borrar(hash, clave);
+        ok = ok && valor && *valor == i;
+        free(valor);
+    }
+    print_test("Prueba hash reducir borrar la mayoria devuelve los datos", ok);
+    print_test("Prueba hash reducir la cantidad es correcta", hash_cantidad(hash) == largo / 10);
+
+    for (size_t i = 0; i < largo && ok; i++) {
+        sprintf(clave, "%08zu", i);
+        size_t *valor = hash_obtener(hash, clave);
+        ok = (i % 10 == 0) ? (valor && *valor == i) : !valor;
+    }
+    print_test("Prueba hash reducir quedan solo las claves no borradas", ok);
+    hash_estadisticas(hash, &estadisticas);
+    print_test("Prueba hash reducir la capacidad bajó", estadisticas.capacidad < capacidad_llena);
+    size_t redimensiones = estadisticas.redimensiones;
+
+    /* Guardar y borrar alrededor de un umbral no pierde elementos ni redimensiona */
+    for (size_t vuelta = 0; vuelta < 50 && ok; vuelta++) {
+        sprintf(clave, "oscila%zu", vuelta);
+        ok = hash_guardar(hash, clave, malloc(1));
+        free(hash_borrar(hash, clave));
+    }
+    print_test("Prueba hash reducir oscilar alrededor de un umbral", ok && hash_cantidad(hash) == largo / 10);
+    hash_estadisticas(hash, &estadisticas);
+    print_test("Prueba hash reducir oscilar no redimensiona", estadisticas.redimensiones == redimensiones);
+
+    print_test("Prueba hash compactar devuelve true", hash_compactar(hash));
+    print_test("Prueba hash compactar no cambia la cantidad", hash_cantidad(hash) == largo / 10);
+    for (size_t i = 0; i < largo && ok; i += 10) {
+        sprintf(clave, "%08zu", i);
+        size_t *valor = hash_obtener(hash, clave);
+        ok = valor && *valor == i;
+    }
+    print_test("Prueba hash compactar conserva todos los elementos", ok);
+    print_test("Prueba hash compactar se puede seguir guardando", hash_guardar(hash, "nueva", malloc(1)));
+    print_test("Prueba hash compactar un hash compacto devuelve true", hash_compactar(hash));
+
+    hash_destruir(hash);
+}
+
+/* Guarda, busca y borra la mitad de las claves de un hash creado con config */
+static bool probar_config(const hash_config_t *config, size_t largo)
+{
+    hash_t* hash = hash_crear_con_config(free, config);
+    if (!hash) return false;
+
+    char clave[24];
+    bool ok = true;
+    for (size_t i = 0; i < largo && ok; i++) {
+        size_t *valor = malloc(sizeof(size_t));
+        *valor = i;
+        sprintf(clave, "%08zu", i);
+        ok = hash_guardar(hash, clave, valor);
+    }
+    for (size_t i = 0; i < largo && ok; i += 2) {
+        sprintf(clave, "%08zu", i);
+        size_t *valor = hash_borrar(hash, clave);
+        ok = valor && *valor == i;
+        free(valor);
+    }
+    for (size_t i = 0; i < largo && ok; i++) {
+        sprintf(clave, "%08zu", i);
+        size_t *valor = hash_obtener(hash, clave);
+        ok = (i % 2 == 0) ? !valor : (valor && *valor == i);
+    }
+    ok = ok && hash_cantidad(hash) == largo / 2;
+    hash_destruir(hash);
+    return ok;
+}
+
+/* Guarda largo claves, borra todas salvo quedan y guarda otras largo claves
+ * nuevas: con un factor de crecimiento grande, el hash se achica varias veces de
+ * golpe y vuelve a crecer mientras todavía está migrando a la tabla chica. */
+static bool probar_borrar_y_guardar(const hash_config_t *config, size_t largo, size_t quedan)
+{
+    hash_t* hash = hash_crear_con_config(NULL, config);
+    if (!hash) return false;
+
+    char clave[24];
+    bool ok = true;
+    for (size_t i = 0; i < largo && ok; i++) {
+        sprintf(clave, "%08zu", i);
+        ok = hash_guardar(hash, clave, (void *) (uintptr_t) (i + 1));
+    }
+    for (size_t i = quedan; i < largo && ok; i++) {
+        sprintf(clave, "%08zu", i);
+        ok = hash_borrar(hash, clave) == (void *) (uintptr_t) (i + 1);
+    }
+    for (size_t i = largo; i < 2 * largo && ok; i++) {
+        sprintf(clave, "%08zu", i);
+        ok = hash_guardar(hash, clave, (void *) (uintptr_t) (i + 1));
+    }
+    for (size_t i = 0; i < 2 * largo && ok; i++) {
+        sprintf(clave, "%08zu", i);
+        void *esperado = (i < quedan || i >= largo) ? (void *) (uintptr_t) (i + 1) : NULL;
+        ok = hash_obtener(hash, clave) == esperado;
+    }
+    ok = ok && hash_cantidad(hash) == quedan + largo;
+    hash_destruir(hash);
+    return ok;
+}
+
+static void *devolver_extra(void *dato, bool existia, void *extra)
+{
+    return extra;
+}
+
+/* Con crecimiento grande, borrar achica el hash de golpe y la migración a la
+ * tabla chica sigue en curso cuando vuelve a crecer. Reservar o compactar
+ * tienen que terminarla sin que la tabla actual se quede sin lugar. */
+static bool probar_achicar_y_terminar(size_t crecimiento, bool compactar)
+{
+    char clave[24];
+    bool ok = true;
+    for (uint64_t semilla = 0; semilla < 64 && ok; semilla++) {
+        hash_config_t config = hash_config_defecto();
+        config.factor_crecimiento = crecimiento;
+        config.semilla = semilla;
+        hash_t* hash = hash_crear_con_config(NULL, &config);
+        if (!hash) return false;
+
+        for (size_t i = 0; i < 15; i++) {
+            sprintf(clave, "%zu", i);
+            hash_guardar(hash, clave, (void *) (uintptr_t) (i + 1));
+        }
+        for (size_t i = 0; i < 8; i++) {
+            sprintf(clave, "%zu", i);
+            hash_borrar(hash, clave);
+        }
+        for (size_t i = 15; i < 27; i++) {
+            sprintf(clave, "%zu", i);
+            hash_guardar(hash, clave, (void *) (uintptr_t) (i + 1));
+        }
+        ok = compactar ? hash_compactar(hash) : hash_reservar(hash, 0);
+        for (size_t i = 8; i < 27 && ok; i++) {
+            sprintf(clave, "%zu", i);
+            ok = hash_obtener(hash, clave) == (void *) (uintptr_t) (i + 1);
+        }
+        ok = ok && hash_cantidad(hash) == 19;
+        hash_destruir(hash);
+    }
+    return ok;
+}
+
+static void prueba_hash_config(size_t largo)
+{
+    hash_config_t config = hash_config_defecto();
+    print_test("Prueba hash config por defecto", probar_config(&config, largo));
+
+    config.factor_carga = 0.5;
+    config.factor_crecimiento = 4;
+    config.capacidad_inicial = 1000;
+    print_test("Prueba hash config disperso con crecimiento 4", probar_config(&config, largo));
+
+    config = hash_config_defecto();
+    config.factor_carga = 0.9375;
+    config.usar_arena = true;
+    print_test("Prueba hash config denso con arena", probar_config(&config, largo));
+
+    config = hash_config_defecto();
+    config.factor_carga = 0.0625;
+    config.funcion = hash_funcion_djb2;
+    print_test("Prueba hash config muy disperso con djb2", probar_config(&config, largo));
+
+    config = hash_config_defecto();
+    config.factor_carga = 1;
+    print_test("Prueba hash config factor de carga 1 es invalido", !hash_crear_con_config(NULL, &config));
+    config.factor_carga = 0;
+    print_test("Prueba hash config factor de carga 0 es invalido", !hash_crear_con_config(NULL, &config));
+
+    config = hash_config_defecto();
+    config.factor_crecimiento = 3;
+    print_test("Prueba hash config crecimiento 3 es invalido", !hash_crear_con_config(NULL, &config));
+    config.factor_crecimiento = 1;
+    print_test("Prueba hash config crecimiento 1 es invalido", !hash_crear_con_config(NULL, &config));
+    config.factor_crecimiento = 128;
+    print_test("Prueba hash config borrar y guardar otras con crecimiento 128", probar_borrar_y_guardar(&config, 2000, 890));
+    config.factor_crecimiento = 256;
+    print_test("Prueba hash config borrar y guardar otras con crecimiento 256", probar_borrar_y_guardar(&config, 4000, 1700));
+    print_test("Prueba hash config reservar tras achicar con crecimiento 256", probar_achicar_y_terminar(256, false));
+    print_test("Prueba hash config compactar tras achicar con crecimiento 256", probar_achicar_y_terminar(256, true));
+    print_test("Prueba hash config compactar tras achicar con crecimiento 128", probar_achicar_y_terminar(128, true));
+    config.factor_crecimiento = 512;
+    print_test("Prueba hash config crecimiento 512 es invalido", !hash_crear_con_config(NULL, &config));
+
+    // Con la tabla llena de borrados, reservar reacomoda sin bajar de la capacidad inicial.
+    config = hash_config_defecto();
+    config.capacidad_inicial = 1500;
+    hash_t *hash = hash_crear_con_config(NULL, &config);
+    hash_estadisticas_t estadisticas;
+    hash_estadisticas(hash, &estadisticas);
+    size_t capacidad_inicial = estadisticas.capacidad;
+    char clave[24];
+    size_t llenas = capacidad_inicial * 7 / 8;
+    for (size_t i = 0; i < llenas; i++) {
+        sprintf(clave, "%zu", i);
+        hash_guardar(hash, clave, NULL);
+    }
+    for (size_t i = 0; i < llenas; i++) {
+        sprintf(clave, "%zu", i);
+        hash_borrar(hash, clave);
+    }
+    // Pide justo lo que no entra contando los borrados, que es menos de la mitad de la capacidad.
+    hash_estadisticas(hash, &estadisticas);
+    print_test("Prueba hash config reservar con borrados devuelve true",
+               hash_reservar(hash, llenas - estadisticas.borrados + 1));
+    hash_estadisticas(hash, &estadisticas);
+    print_test("Prueba hash config reservar no achica por debajo de la capacidad inicial",
+               estadisticas.capacidad >= capacidad_inicial);
+    print_test("Prueba hash config reservar descarta los borrados", estadisticas.borrados == 0);
+    hash_destruir(hash);
+
+    // Con la tabla justo en el factor de carga, reemplazar o encontrar no la agranda.
+    hash = hash_crear(NULL);
+    hash_estadisticas(hash, &estadisticas);
+    llenas = estadisticas.capacidad * 7 / 8;
+    for (size_t i = 0; i < llenas; i++) {
+        sprintf(clave, "%zu", i);
+        hash_guardar(hash, clave, NULL);
+    }
+    hash_estadisticas(hash, &estadisticas);
+    size_t redimensiones = estadisticas.redimensiones;
+    bool ok = hash_guardar(hash, "0", &llenas) && hash_obtener_o_insertar(hash, "1", NULL) &&
+              hash_actualizar(hash, "2", devolver_extra, &llenas);
+    hash_estadisticas(hash, &estadisticas);
+    print_test("Prueba hash config reemplazar en el umbral no redimensiona",
+               ok && estadisticas.redimensiones == redimensiones && hash_obtener(hash, "2") == &llenas);
+    hash_guardar(hash, "nueva", NULL);
+    hash_estadisticas(hash, &estadisticas);
+    print_test("Prueba hash config insertar en el umbral redimensiona", estadisticas.redimensiones == redimensiones + 1);
+    hash_destruir(hash);
+
+    config = hash_config_defecto();
+    config.capacidad_inicial = SIZE_MAX;
+    print_test("Prueba hash config capacidad inicial imposible", !hash_crear_con_config(NULL, &config));
+}
+
+static size_t sumar_histograma(const hash_estadisticas_t *estadisticas)
+{
+    size_t suma = 0;
+    for (size_t i = 0; i < HASH_LARGO_HISTOGRAMA; i++) suma += estadisticas->histograma_sondeo[i];
+    return suma;
+}
+
+static void prueba_hash_estadisticas(size_t largo)
+{
+    hash_t* hash = hash_crear(NULL);
+    hash_estadisticas_t estadisticas;
+
+    hash_estadisticas(hash, &estadisticas);
+    print_test("Prueba hash estadisticas vacio sin elementos", estadisticas.cantidad == 0);
+    print_test("Prueba hash estadisticas vacio ocupa memoria", estadisticas.bytes_totales > 0);
+    print_test("Prueba hash estadisticas vacio sin redimensiones", estadisticas.redimensiones == 0);
+
+    char clave[24];
+    for (size_t i = 0; i < largo; i++) {
+        sprintf(clave, "%08zu", i);
+        hash_guardar(hash, clave, NULL);
+    }
+    hash_guardar(hash, "una clave de mas de veinticuatro bytes", NULL);
+
+    hash_estadisticas(hash, &estadisticas);
+    print_test("Prueba hash estadisticas cantidad", estadisticas.cantidad == largo + 1);
+    print_test("Prueba hash estadisticas el factor de carga es valido",
+               estadisticas.factor_carga > 0 && estadisticas.factor_carga <= 1);
+    print_test("Prueba hash estadisticas hubo redimensiones", estadisticas.redimensiones > 0);
+    print_test("Prueba hash estadisticas cuenta la clave larga", estadisticas.bytes_claves == 39);
+    print_test("Prueba hash estadisticas el histograma suma la cantidad", sumar_histograma(&estadisticas) == largo + 1);
+    print_test("Prueba hash estadisticas sondeo corto con buena funcion", estadisticas.sondeo_promedio < 2);
+    print_test("Prueba hash estadisticas bytes totales",
+               estadisticas.bytes_totales > estadisticas.bytes_control + estadisticas.bytes_campos);
+
+    for (size_t i = 0; i < largo; i += 2) {
+        sprintf(clave, "%08zu", i);
+        hash_borrar(hash, clave);
+    }
+    hash_compactar(hash);
+    hash_estadisticas(hash, &estadisticas);
+    print_test("Prueba hash estadisticas compactado sin borrados ni migracion",
+               estadisticas.borrados == 0 && !estadisticas.migrando);
+    hash_destruir(hash);
+
+    /* Con una función que manda todo al mismo grupo la distribución es degenerada */
+    hash = hash_crear_con_funcion(NULL, funcion_constante, 0);
+    for (size_t i = 0; i < 400; i++) {
+        sprintf(clave, "%08zu", i);
+        hash_guardar(hash, clave, NULL);
+    }
+    hash_estadisticas(hash, &estadisticas);
+    print_test("Prueba hash estadisticas detecta sondeos largos", estadisticas.sondeo_maximo >= 400 / 16);
+    print_test("Prueba hash estadisticas el histograma acumula los largos",
+               estadisticas.histograma_sondeo[HASH_LARGO_HISTOGRAMA - 1] > 0 &&
+               sumar_histograma(&estadisticas) == 400);
+    hash_destruir(hash);
+
+    hash = hash_crear_con_arena(NULL);
+    hash_estadisticas(hash, &estadisticas);
+    size_t bytes_arena = estadisticas.bytes_claves;
+    hash_guardar(hash, "una clave de mas de veinticuatro bytes", NULL);
+    hash_estadisticas(hash, &estadisticas);
+    print_test("Prueba hash estadisticas con arena cuenta sus losas", estadisticas.bytes_claves > bytes_arena);
+    hash_destruir(hash);
+}
+
+static void prueba_hash_contadores(size_t largo)
+{
+    hash_t* hash = hash_crear(NULL);
+    hash_contadores_t contadores;
+    char clave[24];
+
+    for (size_t i = 0; i < largo; i++) {
+        sprintf(clave, "%08zu", i);
+        hash_guardar(hash, clave, NULL);
+    }
+    hash_guardar(hash, "00000000", NULL);
+    for (size_t i = 0; i < 2 * largo; i++) {
+        sprintf(clave, "%08zu", i);
+        hash_obtener(hash, clave);
+    }
+    for (size_t i = 0; i < largo; i += 2) {
+        sprintf(clave, "%08zu", i);
+        hash_borrar(hash, clave);
+    }
+
+    if (!hash_contadores(hash, &contadores)) {
+        /* Compilado sin -DHASH_CONTADORES: no se cuenta nada */
+        print_test("Prueba hash contadores desactivados quedan en 0",
+                   contadores.consultas == 0 && contadores.inserciones == 0 && contadores.grupos_sondeados == 0);
+        hash_destruir(hash);
+        return;
+    }
+
+    print_test("Prueba hash contadores consultas", contadores.consultas == 2 * largo);
+    print_test("Prueba hash contadores aciertos y fallos",
+               contadores.aciertos == largo && contadores.fallos == largo);
+    print_test("Prueba hash contadores inserciones y reemplazos",
+               contadores.inserciones == largo && contadores.reemplazos == 1);
+    print_test("Prueba hash contadores eliminaciones", contadores.eliminaciones == (largo + 1) / 2);
+    print_test("Prueba hash contadores cada busqueda sondea algun grupo",
+               contadores.grupos_sondeados >= contadores.consultas + contadores.inserciones);
+    print_test("Prueba hash contadores cada acierto compara la clave", contadores.comparaciones >= contadores.aciertos);
+    print_test("Prueba hash contadores tiempo redimensionando", contadores.nanosegundos_redimension > 0);
+
+    hash_contadores_reiniciar(hash);
+    hash_pertenece(hash, "00000001");
+    hash_contadores(hash, &contadores);
+    print_test("Prueba hash contadores reiniciar", contadores.consultas == 1 && contadores.aciertos == 1 &&
+               contadores.inserciones == 0 && contadores.eliminaciones == 0);
+    hash_destruir(hash);
+}
+
+#define RUTA_IMAGEN "prueba_hash_imagen.bin"
+
+/* Guarda en la imagen el número al que apunta el dato, o nada si es NULL */
+static size_t numero_a_bytes(const void *dato, const void **bytes)
+{
+    *bytes = dato;
+    return dato ? sizeof(size_t) : 0;
+}
+
+static void prueba_hash_imagen(size_t largo)
+{
+    hash_t* hash = hash_crear(free);
+    char clave[48];
+
+    for (size_t i = 0; i < largo; i++) {
+        size_t *valor = malloc(sizeof(size_t));
+        *valor = i;
+        /* Una de cada diez claves es larga, para que no entre dentro del campo */
+        sprintf(clave, i % 10 ? "%08zu" : "clave larga de la imagen numero %08zu", i);
+        hash_guardar(hash, clave, valor);
+    }
+    hash_guardar_n(hash, "con\0cero", 8, NULL);
+    for (size_t i = 0; i < largo / 3; i++) {         // deja marcas de borrado en la tabla
+        sprintf(clave, i % 10 ? "%08zu" : "clave larga de la imagen numero %08zu", i);
+        free(hash_borrar(hash, clave));
+    }
+
+    print_test("Prueba hash serializar devuelve true", hash_serializar(hash, RUTA_IMAGEN, numero_a_bytes));
+    hash_mapeado_t *mapa = hash_mapear(RUTA_IMAGEN, NULL);
+    print_test("Prueba hash mapear la imagen", mapa);
+    print_test("Prueba hash mapeado la cantidad es correcta", mapa && hash_mapeado_cantidad(mapa) == hash_cantidad(hash));
+
+    bool ok = mapa != NULL;
+    for (size_t i = 0; i < largo && ok; i++) {
+        sprintf(clave, i % 10 ? "%08zu" : "clave larga de la imagen numero %08zu", i);
+        size_t largo_dato = 0;
+        const size_t *valor = hash_mapeado_obtener(mapa, clave, &largo_dato);
+        ok = (i < largo / 3) ? !valor : (valor && largo_dato == sizeof(size_t) && *valor == i);
+    }
+    print_test("Prueba hash mapeado obtener todas las claves", ok);
+    print_test("Prueba hash mapeado clave binaria", mapa && hash_mapeado_obtener_n(mapa, "con\0cero", 8, NULL));
+    print_test("Prueba hash mapeado clave inexistente", mapa && !hash_mapeado_pertenece(mapa, "no esta"));
+    print_test("Prueba hash mapeado prefijo de una clave", mapa && !hash_mapeado_obtener_n(mapa, "con", 3, NULL));
+    if (mapa) hash_mapeado_cerrar(mapa);
+    hash_destruir(hash);
+
+    /* Sin dato_a_bytes se guardan los punteros; con una función propia hay que volver a pasarla */
+    hash = hash_crear_con_funcion(NULL, funcion_constante, 0);
+    for (size_t i = 0; i < 100; i++) {
+        sprintf(clave, "%zu", i);
+        hash_guardar(hash, clave, (void*) (uintptr_t) (i * 3));
+    }
+    print_test("Prueba hash serializar con funcion propia", hash_serializar(hash, RUTA_IMAGEN, NULL));
+    print_test("Prueba hash mapear sin la funcion propia es NULL", !hash_mapear(RUTA_IMAGEN, NULL));
+    mapa = hash_mapear(RUTA_IMAGEN, funcion_constante);
+    ok = mapa != NULL;
+    for (size_t i = 0; i < 100 && ok; i++) {
+        sprintf(clave, "%zu", i);
+        const uintptr_t *valor = hash_mapeado_obtener(mapa, clave, NULL);
+        ok = valor && *valor == i * 3;
+    }
+    print_test("Prueba hash mapeado guarda los punteros", ok);
+    if (mapa) hash_mapeado_cerrar(mapa);
+    hash_destruir(hash);
+
+    FILE *archivo = fopen(RUTA_IMAGEN, "w");
+    fputs("esto no es una imagen", archivo);
+    fclose(archivo);
+    print_test("Prueba hash mapear un archivo invalido es NULL", !hash_mapear(RUTA_IMAGEN, NULL));
+    remove(RUTA_IMAGEN);
+    print_test("Prueba hash mapear un archivo inexistente es NULL", !hash_mapear(RUTA_IMAGEN, NULL));
+}
+
+/* Suma uno al contador de la clave, creándolo en 1 si no existía */
+static void *sumar_uno(void *dato, bool existia, void *extra)
+{
+    size_t *contador = dato;
+    if (!existia) {
+        contador = malloc(sizeof(size_t));
+        if (!contador) return NULL;
+        *contador = 0;
+    }
+    (*contador)++;
+    (*(size_t*) extra)++;
+    return contador;
+}
+
+static void prueba_hash_obtener_o_insertar(size_t largo)
+{
+    hash_t* hash = hash_crear(NULL);
+    char clave[32];
+
+    /* Cuenta apariciones: la clave i aparece i % 7 + 1 veces, intercaladas */
+    bool ok = true;
+    for (size_t vuelta = 0; vuelta < 7; vuelta++) {
+        for (size_t i = 0; i < largo; i++) {
+            if (vuelta > i % 7) continue;
+            sprintf(clave, "palabra%zu", i);
+            void **dato = hash_obtener_o_insertar(hash, clave, (void*) 0);
+            ok = ok && dato;
+            if (dato) *dato = (void*) ((uintptr_t) *dato + 1);
+        }
+    }
+    print_test("Prueba hash obtener o insertar devuelve siempre el lugar del dato", ok);
+    print_test("Prueba hash obtener o insertar la cantidad es correcta", hash_cantidad(hash) == largo);
+
+    for (size_t i = 0; i < largo && ok; i++) {
+        sprintf(clave, "palabra%zu", i);
+        ok = (uintptr_t) hash_obtener(hash, clave) == i % 7 + 1;
+    }
+    print_test("Prueba hash obtener o insertar conto todas las apariciones", ok);
+
+    void *dato = hash_obtener(hash, "palabra0");
+    print_test("Prueba hash obtener o insertar una clave existente no cambia el dato",
+               *hash_obtener_o_insertar(hash, "palabra0", (void*) 99) == dato);
+    print_test("Prueba hash obtener o insertar una clave nueva guarda el dato inicial",
+               *hash_obtener_o_insertar(hash, "nueva", (void*) 99) == (void*) 99);
+    print_test("Prueba hash obtener o insertar la clave nueva pertenece", hash_pertenece(hash, "nueva"));
+    hash_destruir(hash);
+
+    /* Lo mismo con hash_actualizar y datos en memoria dinámica */
+    hash = hash_crear(free);
+    size_t llamados = 0;
+    ok = true;
+    for (size_t vuelta = 0; vuelta < 3; vuelta++) {
+        for (size_t i = 0; i < largo; i++) {
+            sprintf(clave, "%08zu", i);
+            ok = ok && hash_actualizar(hash, clave, sumar_uno, &llamados);
+        }
+    }
+    print_test("Prueba hash actualizar devuelve true", ok);
+    print_test("Prueba hash actualizar llamo a la funcion una vez por clave", llamados == 3 * largo);
+    print_test("Prueba hash actualizar la cantidad es correcta", hash_cantidad(hash) == largo);
+
+    for (size_t i = 0; i < largo && ok; i++) {
+        sprintf(clave, "%08zu", i);
+        size_t *contador = hash_obtener(hash, clave);
+        ok = contador && *contador == 3;
+    }
+    print_test("Prueba hash actualizar actualizo todos los datos", ok);
+    hash_destruir(hash);
+}
+
 static ssize_t buscar(const char* clave, char* claves[], size_t largo)
 {
     for (size_t i = 0; i < largo; i++) {
@@ -329,6 +1178,93 @@ static void prueba_hash_iterar()
     hash_destruir(hash);
 }
 
+static bool sumar_valores(const char *clave, void *dato, void *extra)
+{
+    *(size_t *) extra += *(size_t *) dato;
+    return true;
+}
+
+static bool contar_hasta_diez(const char *clave, void *dato, void *extra)
+{
+    size_t *contador = extra;
+    (*contador)++;
+    return *contador < 10;
+}
+
+static void prueba_hash_iterar_interno(size_t largo)
+{
+    hash_t* hash = hash_crear(NULL);
+    size_t *valores = malloc(largo * sizeof(size_t));
+    char clave[24];
+
+    size_t esperado = 0;
+    for (size_t i = 0; i < largo; i++) {
+        sprintf(clave, "%08zu", i);
+        valores[i] = i;
+        esperado += i;
+        hash_guardar(hash, clave, &valores[i]);
+    }
+
+    size_t suma = 0;
+    hash_iterar(hash, sumar_valores, &suma);
+    print_test("Prueba hash iterar interno visita todos los elementos", suma == esperado);
+
+    size_t contador = 0;
+    hash_iterar(hash, contar_hasta_diez, &contador);
+    print_test("Prueba hash iterar interno corta cuando visitar devuelve false", contador == 10);
+
+    /* Iterador externo declarado en el stack */
+    hash_iter_t iter;
+    size_t iterados = 0;
+    bool ok = true;
+    for (hash_iter_iniciar(&iter, hash); !hash_iter_al_final(&iter); hash_iter_avanzar(&iter)) {
+        ok = ok && hash_pertenece(hash, hash_iter_ver_actual(&iter));
+        iterados++;
+    }
+    print_test("Prueba hash iterador en el stack recorre todos los elementos", ok && iterados == largo);
+
+    free(valores);
+    hash_destruir(hash);
+}
+
+static void prueba_hash_iterar_valores(size_t largo)
+{
+    hash_t* hash = hash_crear(free);
+    char clave[24];
+
+    for (size_t i = 0; i < largo; i++) {
+        size_t *valor = malloc(sizeof(size_t));
+        *valor = i;
+        sprintf(clave, "%08zu", i);
+        hash_guardar(hash, clave, valor);
+    }
+
+    /* Duplica cada valor reemplazándolo desde el iterador (se libera el anterior) */
+    bool ok = true;
+    hash_iter_t iter;
+    for (hash_iter_iniciar(&iter, hash); !hash_iter_al_final(&iter); hash_iter_avanzar(&iter)) {
+        size_t *valor = hash_iter_ver_valor(&iter);
+        ok = ok && valor && *valor == (size_t) atol(hash_iter_ver_actual(&iter));
+
+        size_t *doble = malloc(sizeof(size_t));
+        *doble = *valor * 2;
+        ok = ok && hash_iter_reemplazar_valor(&iter, doble) && hash_iter_ver_valor(&iter) == doble;
+    }
+    print_test("Prueba hash iterador ver valor devuelve el dato de cada clave", ok);
+    print_test("Prueba hash iterador ver valor al final es NULL", !hash_iter_ver_valor(&iter));
+    print_test("Prueba hash iterador reemplazar valor al final es false", !hash_iter_reemplazar_valor(&iter, NULL));
+
+    for (size_t i = 0; i < largo && ok; i++) {
+        sprintf(clave, "%08zu", i);
+        size_t *valor = hash_obtener(hash, clave);
+        ok = valor && *valor == i * 2;
+    }
+    print_test("Prueba hash iterador reemplazar valor actualizo todos los elementos", ok);
+    print_test("Prueba hash la cantidad de elementos no cambio", hash_cantidad(hash) == largo);
+
+    hash_destruir(hash);
+}
+
 static void prueba_hash_iterar_volumen(size_t largo)
 {
     hash_t* hash = hash_crear(NULL);
@@ -336,7 +1272,7 @@ static void prueba_hash_iterar_volumen(size_t largo)
     const size_t largo_clave = 10;
     char (*claves)[largo_clave] = malloc(largo * largo_clave);
 
-    size_t valores[largo];
+    size_t *valores = malloc(largo * sizeof(size_t));
 
     /* Inserta 'largo' parejas en el hash */
     bool ok = true;
@@ -388,6 +1324,7 @@ static void prueba_hash_iterar_volumen(size_t largo)
     print_test("Prueba hash iteración en volumen, se cambiaron todo los elementos", ok);
 
     free(claves);
+    free(valores);
     hash_iter_destruir(iter);
     hash_destruir(hash);
 }
@@ -409,11 +1346,29 @@ void pruebas_hash_catedra()
     prueba_hash_clave_vacia();
     prueba_hash_valor_null();
     prueba_hash_volumen(5000, true);
+    prueba_hash_fallos_con_borrados(5000);
+    prueba_hash_reducir(10000);
+    prueba_hash_config(5000);
+    prueba_hash_estadisticas(5000);
+    prueba_hash_contadores(5000);
+    prueba_hash_imagen(5000);
+    prueba_hash_funcion_propia(300);
+    prueba_hash_redimensionar_sin_rehashear(5000);
+    prueba_hash_migracion_incremental(1800);
+    prueba_hash_arena(1000);
+    prueba_hash_claves_prefijo();
+    prueba_hash_claves_binarias();
+    prueba_hash_obtener_lote(1001);
+    prueba_hash_guardar_lote(5000);
+    prueba_hash_obtener_o_insertar(5000);
     prueba_hash_iterar();
     prueba_hash_iterar_volumen(5000);
+    prueba_hash_iterar_interno(1800);
+    prueba_hash_iterar_valores(1000);
 }
 
 void pruebas_volumen_catedra(size_t largo)
 {
     prueba_hash_volumen(largo, false);
 }
+
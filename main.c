@@ -8,6 +8,10 @@
 
 void pruebas_hash_catedra(void);
 void pruebas_volumen_catedra(size_t);
+void pruebas_hash_concurrente(void);
+void pruebas_hash_flujo(void);
+void pruebas_hash_congelado(void);
+void pruebas_hash_generico(void);
 
 int main(int argc, char *argv[])
 {
@@ -22,5 +26,17 @@ int main(int argc, char *argv[])
     printf("\n~~~ PRUEBAS CÁTEDRA ~~~\n");
     pruebas_hash_catedra();
 
+    printf("\n~~~ PRUEBAS HASH CONCURRENTE ~~~\n");
+    pruebas_hash_concurrente();
+
+    printf("\n~~~ PRUEBAS HASH FLUJO ~~~\n");
+    pruebas_hash_flujo();
+
+    printf("\n~~~ PRUEBAS HASH CONGELADO ~~~\n");
+    pruebas_hash_congelado();
+
+    printf("\n~~~ PRUEBAS HASH GENÉRICO ~~~\n");
+    pruebas_hash_generico();
+
     return failure_count() > 0;
 }